@@ -32,6 +32,7 @@ extern "C" {
 protected: \
     struct Impl; \
     Impl* pImpl; \
+    friend struct Accessor; \
     A(const A&) = delete; \
     const A& operator=(const A&) = delete; \
     A()
@@ -798,7 +799,7 @@ public:
      * @param[in] pts The array of the two-dimensional points.
      * @param[in] ptsCnt The number of the points in the @p pts array.
      *
-     * @return Result::Success when succeed, Result::InvalidArguments otherwise.
+     * @return Result::Success when succeed, Result::InvalidArguments or Result::FailedAllocation otherwise.
      *
      * @note The interface is designed for optimal path setting if the caller has a completed path commands already.
      */
@@ -1027,6 +1028,19 @@ class TVG_EXPORT Picture final : public Paint
 public:
     ~Picture();
 
+    /**
+     * @brief Enumeration specifying the memory layout of the raw pixels.
+     *
+     * @BETA_API
+     */
+    enum PixelFormat
+    {
+        Color32 = 0,  ///< 32-bit premultiplied color, the channels are joined in the order of the target canvas colorspace.
+        A8,           ///< 8-bit alpha, the pixels are painted with the color given by tint().
+        L8,           ///< 8-bit luminance of the opaque grayscale pixels.
+        RGB565        ///< 16-bit opaque color, 5 bits red, 6 bits green and 5 bits blue from the most significant bit.
+    };
+
     /**
      * @brief Loads a picture data directly from a file.
      *
@@ -1060,12 +1074,56 @@ public:
      */
     Result load(const char* data, uint32_t size, bool copy = false) noexcept;
 
+    /**
+     * @brief Loads a picture data delivered in chunks, one chunk per call.
+     *
+     * Each chunk is parsed as it arrives, so the loading goes along with the data transfer.
+     * The viewbox and the size of the picture are available as soon as the header of the data is fed.
+     * The chunks are copied, the @p data can be released after the call.
+     *
+     * @param[in] data A pointer to the next chunk of the picture data.
+     * @param[in] size The size in bytes of the chunk.
+     *
+     * @retval Result::Success When succeed.
+     * @retval Result::InvalidArguments In case no data are provided or the @p size is zero or less.
+     * @retval Result::NonSupport When no loader can parse the data in chunks.
+     * @retval Result::Unknown If the chunk could not be parsed.
+     *
+     * @note This api supports only SVG format.
+     * @see finish()
+     * @warning Please do not use it, this API is not official one. It could be modified in the next version.
+     *
+     * @BETA_API
+     */
+    Result feed(const char* data, uint32_t size) noexcept;
+
+    /**
+     * @brief Completes the picture data delivered by feed().
+     *
+     * The picture is not drawn until the feeding is finished.
+     *
+     * @retval Result::Success When succeed.
+     * @retval Result::InsufficientCondition In case no data have been fed.
+     * @retval Result::Unknown If the fed data is not a valid picture.
+     *
+     * @note The finish behavior can be asynchronous if the assigned thread number is greater than zero.
+     * @see feed()
+     * @warning Please do not use it, this API is not official one. It could be modified in the next version.
+     *
+     * @BETA_API
+     */
+    Result finish() noexcept;
+
     /**
      * @brief Resize the picture content with the given width and height.
      *
      * Resize the picture content while keeping the default size aspect ratio.
      * The scaling factor is established for each of dimensions and the smaller value is applied to both of them.
      *
+     * @note A raster image is drawn in its own size. If the size is set before the image is loaded, it's taken as the hint of the drawn size:
+     *       a JPG image may be decoded in the reduced resolution which still covers it, and scaled back up to its own size.
+     *       data() returns the reduced pixels then, and the picture is expected to be scaled down to the size by its transform.
+     *
      * @param[in] w A new width of the image in pixels.
      * @param[in] h A new height of the image in pixels.
      *
@@ -1086,12 +1144,31 @@ public:
     /**
      * @brief Gets the pixels information of the picture.
      *
+     * The pixels kept in a compact format are expanded into the 32-bit ones, valid until the next call.
+     *
      * @warning Please do not use it, this API is not official one. It could be modified in the next version.
      *
      * @BETA_API
      */
     const uint32_t* data() const noexcept;
 
+    /**
+     * @brief Gets the pixels of the picture as they are kept, with their layout.
+     *
+     * @param[out] w The width of the image in pixels.
+     * @param[out] h The height of the image in pixels.
+     * @param[out] stride The number of pixels of a row of the returned data.
+     * @param[out] format The memory layout of the returned data.
+     *
+     * @return The first pixel of the image, @c nullptr if it has no pixels.
+     *
+     * @see data()
+     * @warning Please do not use it, this API is not official one. It could be modified in the next version.
+     *
+     * @BETA_API
+     */
+    const void* data(uint32_t* w, uint32_t* h, uint32_t* stride, PixelFormat* format) const noexcept;
+
     /**
      * @brief Set paint for the picture.
      *
@@ -1116,6 +1193,68 @@ public:
      */
     Result load(uint32_t* data, uint32_t w, uint32_t h, bool copy) noexcept;
 
+    /**
+     * @brief Loads a region of a raw data, whose rows are placed @p stride pixels apart in the memory.
+     *
+     * This allows to load a sub image of a sprite sheet or a padded video frame without any copy.
+     *
+     * @param[in] data A pointer to the first pixel of the whole raw data.
+     * @param[in] stride The number of pixels of a row of the @p data.
+     * @param[in] x The horizontal position of the region in pixels.
+     * @param[in] y The vertical position of the region in pixels.
+     * @param[in] w The width of the region in pixels.
+     * @param[in] h The height of the region in pixels.
+     * @param[in] copy Decides whether the region should be copied into the engine local buffer.
+     *
+     * @retval Result::Success When succeed.
+     * @retval Result::InvalidArguments In case no data are provided or the region is out of the @p stride.
+     *
+     * @note If the @p copy is false, the @p data must be kept alive while the picture is used.
+     * @warning Please do not use it, this API is not official one. It could be modified in the next version.
+     *
+     * @BETA_API
+     */
+    Result load(uint32_t* data, uint32_t stride, uint32_t x, uint32_t y, uint32_t w, uint32_t h, bool copy) noexcept;
+
+    /**
+     * @brief Loads a raw data kept in the given pixel format.
+     *
+     * The pixels stay in the compact format and are expanded by the raster engine on drawing,
+     * so that a mask or a grayscale image takes a quarter of the memory of the 32-bit one.
+     *
+     * @param[in] data A pointer to the first pixel of the raw data.
+     * @param[in] format The memory layout of the @p data.
+     * @param[in] w The width of the image in pixels.
+     * @param[in] h The height of the image in pixels.
+     * @param[in] stride The number of pixels of a row of the @p data.
+     * @param[in] copy Decides whether the data should be copied into the engine local buffer.
+     *
+     * @retval Result::Success When succeed.
+     * @retval Result::InvalidArguments In case no data are provided or the @p stride is less than the @p w.
+     *
+     * @see tint()
+     * @warning Please do not use it, this API is not official one. It could be modified in the next version.
+     *
+     * @BETA_API
+     */
+    Result load(const void* data, PixelFormat format, uint32_t w, uint32_t h, uint32_t stride, bool copy) noexcept;
+
+    /**
+     * @brief Sets the color of the picture loaded with the PixelFormat::A8.
+     *
+     * @param[in] r The red color channel value in the range [0 ~ 255]. The default value is 0.
+     * @param[in] g The green color channel value in the range [0 ~ 255]. The default value is 0.
+     * @param[in] b The blue color channel value in the range [0 ~ 255]. The default value is 0.
+     *
+     * @return Result::Success when succeed.
+     *
+     * @note The pixels of the other formats are not affected.
+     * @warning Please do not use it, this API is not official one. It could be modified in the next version.
+     *
+     * @BETA_API
+     */
+    Result tint(uint8_t r, uint8_t g, uint8_t b) noexcept;
+
     /**
      * @brief Gets the position and the size of the loaded picture.
      *
@@ -1374,6 +1513,58 @@ public:
      */
     static Result term(CanvasEngine engine) noexcept;
 
+    /**
+     * @brief Sets the memory budget of the resource cache shared by the pictures.
+     *
+     * The pictures loading the same file, identified by its canonical path, modification time and size,
+     * or the same data, identified by its contents, share the decoded pixels or the parsed scene instead of loading it again.
+     * When the resources exceed the @p bytes, the least recently used ones are dropped from the cache.
+     * The pictures already loaded keep their resources regardless of the cache.
+     *
+     * @param[in] bytes The memory budget in bytes. Zero disables the cache, which is the default.
+     *
+     * @return Result::Success when succeed.
+     *
+     * @note The memory of a vector resource is estimated by the size of its source data.
+     * @see Initializer::purge()
+     *
+     * @BETA_API
+     */
+    static Result cache(uint32_t bytes) noexcept;
+
+    /**
+     * @brief Sets the directory keeping the SVG data compiled into the binary format.
+     *
+     * The scene built from an SVG data is saved in the directory, named by the hash of the data and the ThorVG version.
+     * The next loads of the same data, even in another process, read the saved scene without parsing the SVG again.
+     *
+     * @param[in] dir The path to an existing directory. An empty path disables the compiling, which is the default.
+     *
+     * @retval Result::Success When succeed.
+     * @retval Result::InvalidArguments The @p dir is not a directory.
+     * @retval Result::NonSupport The TVG loader is not built in.
+     *
+     * @note The files are not removed by ThorVG, the application manages the directory.
+     * @note Set it before loading the pictures, it's not guarded against the loads in the other threads.
+     *
+     * @BETA_API
+     */
+    static Result storage(const std::string& dir) noexcept;
+
+    /**
+     * @brief Drops all the resources kept in the cache.
+     *
+     * The budget set by cache() is kept.
+     *
+     * @return Result::Success when succeed.
+     *
+     * @note The cache is purged also when the engines are terminated.
+     * @see Initializer::cache()
+     *
+     * @BETA_API
+     */
+    static Result purge() noexcept;
+
     _TVG_DISABLE_CTOR(Initializer);
 };
 
@@ -291,6 +291,52 @@ TVG_EXPORT Tvg_Result tvg_engine_init(unsigned engine_method, unsigned threads);
 TVG_EXPORT Tvg_Result tvg_engine_term(unsigned engine_method);
 
 
+/*!
+* \brief Sets the memory budget of the resource cache shared by the pictures. (BETA version)
+*
+* The pictures loading the same file or the same data share the decoded pixels or the parsed scene instead of loading it again.
+* When the resources exceed the @p bytes, the least recently used ones are dropped from the cache.
+*
+* \param[in] bytes The memory budget in bytes. Zero disables the cache, which is the default.
+*
+* \return Tvg_Result enumeration.
+* \retval TVG_RESULT_SUCCESS Succeed.
+*
+* \see tvg_engine_purge()
+* \warning Please do not use it, this API is not official one. It can be modified in the next version.
+*/
+TVG_EXPORT Tvg_Result tvg_engine_cache(uint32_t bytes);
+
+
+/*!
+* \brief Sets the directory keeping the SVG data compiled into the binary format. (BETA version)
+*
+* The next loads of the same SVG data read the saved scene without parsing it again.
+*
+* \param[in] dir The path to an existing directory. An empty path disables the compiling, which is the default.
+*
+* \return Tvg_Result enumeration.
+* \retval TVG_RESULT_SUCCESS Succeed.
+* \retval TVG_RESULT_INVALID_ARGUMENT The @p dir is not a directory.
+* \retval TVG_RESULT_NOT_SUPPORTED The TVG loader is not built in.
+*
+* \warning Please do not use it, this API is not official one. It can be modified in the next version.
+*/
+TVG_EXPORT Tvg_Result tvg_engine_storage(const char* dir);
+
+
+/*!
+* \brief Drops all the resources kept in the cache. (BETA version)
+*
+* \return Tvg_Result enumeration.
+* \retval TVG_RESULT_SUCCESS Succeed.
+*
+* \see tvg_engine_cache()
+* \warning Please do not use it, this API is not official one. It can be modified in the next version.
+*/
+TVG_EXPORT Tvg_Result tvg_engine_purge();
+
+
 /** \} */   // end defgroup ThorVGCapi_Initializer
 
 
@@ -1670,6 +1716,27 @@ TVG_EXPORT Tvg_Result tvg_picture_load(Tvg_Paint* paint, const char* path);
 TVG_EXPORT Tvg_Result tvg_picture_load_raw(Tvg_Paint* paint, uint32_t *data, uint32_t w, uint32_t h, bool copy);
 
 
+/*!
+* \brief Loads a region of a raw data, whose rows are placed @p stride pixels apart in the memory. (BETA version)
+*
+* \param[in] paint A Tvg_Paint pointer to the picture object.
+* \param[in] data A pointer to the first pixel of the whole raw data.
+* \param[in] stride The number of pixels of a row of the @p data.
+* \param[in] x The horizontal position of the region in pixels.
+* \param[in] y The vertical position of the region in pixels.
+* \param[in] w The width of the region in pixels.
+* \param[in] h The height of the region in pixels.
+* \param[in] copy Decides whether the region should be copied into the engine local buffer.
+*
+* \return Tvg_Result enumeration.
+* \retval TVG_RESULT_SUCCESS Succeed.
+* \retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Paint pointer, no @p data or the region is out of the @p stride.
+*
+* \warning Please do not use it, this API is not official one. It can be modified in the next version.
+*/
+TVG_EXPORT Tvg_Result tvg_picture_load_raw_region(Tvg_Paint* paint, uint32_t *data, uint32_t stride, uint32_t x, uint32_t y, uint32_t w, uint32_t h, bool copy);
+
+
 /*!
 * \brief The function loads data into given paint object. (BETA version)
 *
@@ -1687,6 +1754,44 @@ TVG_EXPORT Tvg_Result tvg_picture_load_raw(Tvg_Paint* paint, uint32_t *data, uin
 TVG_EXPORT Tvg_Result tvg_picture_load_data(Tvg_Paint* paint, const char *data, uint32_t size, bool copy);
 
 
+/*!
+* \brief Loads a picture data delivered in chunks, one chunk per call. (BETA version)
+*
+* The viewbox of the picture is available as soon as the header of the data is fed.
+*
+* \param[in] paint A Tvg_Paint pointer to the picture object.
+* \param[in] data A pointer to the next chunk of the picture data, it's copied.
+* \param[in] size The size in bytes of the chunk.
+*
+* \return Tvg_Result enumeration.
+* \retval TVG_RESULT_SUCCESS Succeed.
+* \retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Paint pointer or no @p data.
+* \retval TVG_RESULT_NOT_SUPPORTED No loader can parse the data in chunks.
+* \retval TVG_RESULT_UNKNOWN The chunk could not be parsed.
+*
+* \note Only the SVG format is supported.
+* \see tvg_picture_finish()
+* \warning Please do not use it, this API is not official one. It can be modified in the next version.
+*/
+TVG_EXPORT Tvg_Result tvg_picture_feed(Tvg_Paint* paint, const char *data, uint32_t size);
+
+
+/*!
+* \brief Completes the picture data delivered by tvg_picture_feed(). (BETA version)
+*
+* \param[in] paint A Tvg_Paint pointer to the picture object.
+*
+* \return Tvg_Result enumeration.
+* \retval TVG_RESULT_SUCCESS Succeed.
+* \retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Paint pointer.
+* \retval TVG_RESULT_INSUFFICIENT_CONDITION No data have been fed.
+* \retval TVG_RESULT_UNKNOWN The fed data is not a valid picture.
+*
+* \warning Please do not use it, this API is not official one. It can be modified in the next version.
+*/
+TVG_EXPORT Tvg_Result tvg_picture_finish(Tvg_Paint* paint);
+
+
 /*!
 * \brief Gets the position and the size of the loaded picture. (BETA version)
 *
@@ -49,6 +49,25 @@ TVG_EXPORT Tvg_Result tvg_engine_term(unsigned engine_method)
     return (Tvg_Result) Initializer::term(CanvasEngine(engine_method));
 }
 
+
+TVG_EXPORT Tvg_Result tvg_engine_cache(uint32_t bytes)
+{
+    return (Tvg_Result) Initializer::cache(bytes);
+}
+
+
+TVG_EXPORT Tvg_Result tvg_engine_storage(const char* dir)
+{
+    if (!dir) return TVG_RESULT_INVALID_ARGUMENT;
+    return (Tvg_Result) Initializer::storage(dir);
+}
+
+
+TVG_EXPORT Tvg_Result tvg_engine_purge()
+{
+    return (Tvg_Result) Initializer::purge();
+}
+
 /************************************************************************/
 /* Canvas API                                                           */
 /************************************************************************/
@@ -463,6 +482,13 @@ TVG_EXPORT Tvg_Result tvg_picture_load_raw(Tvg_Paint* paint, uint32_t *data, uin
 }
 
 
+TVG_EXPORT Tvg_Result tvg_picture_load_raw_region(Tvg_Paint* paint, uint32_t *data, uint32_t stride, uint32_t x, uint32_t y, uint32_t w, uint32_t h, bool copy)
+{
+    if (!paint) return TVG_RESULT_INVALID_ARGUMENT;
+    return (Tvg_Result) reinterpret_cast<Picture*>(paint)->load(data, stride, x, y, w, h, copy);
+}
+
+
 TVG_EXPORT Tvg_Result tvg_picture_load_data(Tvg_Paint* paint, const char *data, uint32_t size, bool copy)
 {
     if (!paint) return TVG_RESULT_INVALID_ARGUMENT;
@@ -470,6 +496,20 @@ TVG_EXPORT Tvg_Result tvg_picture_load_data(Tvg_Paint* paint, const char *data,
 }
 
 
+TVG_EXPORT Tvg_Result tvg_picture_feed(Tvg_Paint* paint, const char *data, uint32_t size)
+{
+    if (!paint) return TVG_RESULT_INVALID_ARGUMENT;
+    return (Tvg_Result) reinterpret_cast<Picture*>(paint)->feed(data, size);
+}
+
+
+TVG_EXPORT Tvg_Result tvg_picture_finish(Tvg_Paint* paint)
+{
+    if (!paint) return TVG_RESULT_INVALID_ARGUMENT;
+    return (Tvg_Result) reinterpret_cast<Picture*>(paint)->finish();
+}
+
+
 TVG_EXPORT Tvg_Result tvg_picture_get_viewbox(const Tvg_Paint* paint, float* x, float* y, float* w, float* h)
 {
     if (!paint) return TVG_RESULT_INVALID_ARGUMENT;
@@ -26,10 +26,10 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-static bool _genOutline(SwImage* image, const Picture* pdata, const Matrix* transform, SwMpool* mpool,  unsigned tid)
+static bool _genOutline(SwImage* image, const Matrix* transform, SwMpool* mpool,  unsigned tid)
 {
-    float w, h;
-    pdata->viewbox(nullptr, nullptr, &w, &h);
+    auto w = static_cast<float>(image->w);
+    auto h = static_cast<float>(image->h);
     if (w == 0 || h == 0) return false;
 
     image->outline = mpoolReqOutline(mpool, tid);
@@ -59,8 +59,6 @@ static bool _genOutline(SwImage* image, const Picture* pdata, const Matrix* tran
     outline->opened = false;
 
     image->outline = outline;
-    image->w = w;
-    image->h = h;
 
     return true;
 }
@@ -71,9 +69,9 @@ static bool _genOutline(SwImage* image, const Picture* pdata, const Matrix* tran
 /************************************************************************/
 
 
-bool imagePrepare(SwImage* image, const Picture* pdata, const Matrix* transform, const SwBBox& clipRegion, SwBBox& renderRegion, SwMpool* mpool, unsigned tid)
+bool imagePrepare(SwImage* image, const Matrix* transform, const SwBBox& clipRegion, SwBBox& renderRegion, SwMpool* mpool, unsigned tid)
 {
-    if (!_genOutline(image, pdata, transform, mpool, tid)) return false;
+    if (!_genOutline(image, transform, mpool, tid)) return false;
     return mathUpdateOutlineBBox(image->outline, clipRegion, renderRegion);
 }
 
@@ -84,7 +82,7 @@ bool imagePrepared(const SwImage* image)
 }
 
 
-bool imageGenRle(SwImage* image, TVG_UNUSED const Picture* pdata, const SwBBox& renderRegion, bool antiAlias)
+bool imageGenRle(SwImage* image, const SwBBox& renderRegion, bool antiAlias)
 {
     if ((image->rle = rleRender(image->rle, image->outline, renderRegion, antiAlias))) return true;
 
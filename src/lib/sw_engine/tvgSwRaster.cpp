@@ -72,20 +72,47 @@ static bool _inverse(const Matrix* transform, Matrix* invM)
 }
 
 
-static bool _identify(const Matrix* transform)
+static bool _translation(const Matrix* transform, int32_t* tx, int32_t* ty)
 {
-    if (transform) {
-        if (transform->e11 != 1.0f || transform->e12 != 0.0f || transform->e13 != 0.0f ||
-            transform->e21 != 0.0f || transform->e22 != 1.0f || transform->e23 != 0.0f ||
-            transform->e31 != 0.0f || transform->e32 != 0.0f || transform->e33 != 1.0f) {
-            return false;
-        }
+    *tx = *ty = 0;
+
+    if (!transform) return true;
+
+    if (transform->e11 != 1.0f || transform->e12 != 0.0f || transform->e21 != 0.0f || transform->e22 != 1.0f ||
+        transform->e31 != 0.0f || transform->e32 != 0.0f || transform->e33 != 1.0f) {
+        return false;
     }
 
+    //Only pixel aligned shifts are allowed
+    if (transform->e13 != floorf(transform->e13) || transform->e23 != floorf(transform->e23)) return false;
+
+    *tx = static_cast<int32_t>(transform->e13);
+    *ty = static_cast<int32_t>(transform->e23);
+
     return true;
 }
 
 
+static bool _axisAligned(Matrix* invTransform, const SwBBox& region)
+{
+    //Ignorable factors which can't move a sample within the region. (ie, cosf(90) is not exact zero)
+    auto range = static_cast<float>(abs(region.max.x) + abs(region.max.y));
+
+    if (fabsf(invTransform->e12) * range < 0.01f && fabsf(invTransform->e21) * range < 0.01f) {
+        invTransform->e12 = invTransform->e21 = 0.0f;
+        return (invTransform->e11 != 0.0f && invTransform->e22 != 0.0f);
+    }
+
+    //90 or 270 degree rotated
+    if (fabsf(invTransform->e11) * range < 0.01f && fabsf(invTransform->e22) * range < 0.01f) {
+        invTransform->e11 = invTransform->e22 = 0.0f;
+        return (invTransform->e12 != 0.0f && invTransform->e21 != 0.0f);
+    }
+
+    return false;
+}
+
+
 static bool _translucent(const SwSurface* surface, uint8_t a)
 {
     if (a < 255) return true;
@@ -305,24 +332,81 @@ static bool _rasterSolidRle(SwSurface* surface, const SwRleData* rle, uint32_t c
 /* Image                                                                */
 /************************************************************************/
 
-static bool _rasterTranslucentImageRle(SwSurface* surface, const SwRleData* rle, uint32_t *img, uint32_t w, uint32_t h, uint32_t opacity)
+/* Map the columns of the axis-aligned (scaled, flipped or 90 degree rotated) image.
+   Source offset of a pixel is separable into a row part and a column part,
+   thus the column part is resolved once and reused by the every rows.
+   Out of the image boundary is marked with -1. */
+static void _mapColumns(const SwImage* image, const Matrix* invTransform, SwCoord x, uint32_t len, int32_t* cols)
+{
+    for (uint32_t i = 0; i < len; ++i, ++x) {
+        //Not Rotated
+        if (invTransform->e21 == 0.0f) {
+            auto rX = static_cast<int32_t>(roundf(x * invTransform->e11 + invTransform->e13));
+            cols[i] = (rX < 0 || rX >= static_cast<int32_t>(image->w)) ? -1 : rX;
+        //Rotated
+        } else {
+            auto rY = static_cast<int32_t>(roundf(x * invTransform->e21 + invTransform->e23));
+            cols[i] = (rY < 0 || rY >= static_cast<int32_t>(image->h)) ? -1 : rY * image->stride;
+        }
+    }
+}
+
+
+static bool _mapRow(const SwImage* image, const Matrix* invTransform, SwCoord y, uint32_t* offset)
+{
+    //Not Rotated
+    if (invTransform->e21 == 0.0f) {
+        auto rY = static_cast<int32_t>(roundf(y * invTransform->e22 + invTransform->e23));
+        if (rY < 0 || rY >= static_cast<int32_t>(image->h)) return false;
+        *offset = rY * image->stride;
+    //Rotated
+    } else {
+        auto rX = static_cast<int32_t>(roundf(y * invTransform->e12 + invTransform->e13));
+        if (rX < 0 || rX >= static_cast<int32_t>(image->w)) return false;
+        *offset = rX;
+    }
+    return true;
+}
+
+
+static bool _rasterTranslucentImageRle(SwSurface* surface, const SwRleData* rle, const SwImage* image, uint32_t opacity, int32_t tx, int32_t ty)
 {
     auto span = rle->spans;
 
     for (uint32_t i = 0; i < rle->size; ++i, ++span) {
         auto dst = &surface->buffer[span->y * surface->stride + span->x];
-        auto src = img + span->x + span->y * w;    //TODO: need to use image's stride
+        auto src = image->data + (span->x - tx) + (span->y - ty) * image->stride;
         auto alpha = ALPHA_MULTIPLY(span->coverage, opacity);
         for (uint32_t x = 0; x < span->len; ++x, ++dst, ++src) {
-            *src = ALPHA_BLEND(*src, alpha);
-            *dst = *src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(*src));
+            auto tmp = ALPHA_BLEND(*src, alpha);
+            *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
         }
     }
     return true;
 }
 
 
-static bool _rasterTranslucentImageRle(SwSurface* surface, const SwRleData* rle, uint32_t *img, uint32_t w, uint32_t h, uint32_t opacity, const Matrix* invTransform)
+static bool _rasterTranslucentImageRle(SwSurface* surface, const SwRleData* rle, const SwImage* image, uint32_t opacity, const SwBBox& region, const int32_t* cols, const Matrix* invTransform)
+{
+    auto span = rle->spans;
+
+    for (uint32_t i = 0; i < rle->size; ++i, ++span) {
+        uint32_t offset;
+        if (!_mapRow(image, invTransform, span->y, &offset)) continue;
+        auto dst = &surface->buffer[span->y * surface->stride + span->x];
+        auto col = cols + (span->x - region.min.x);
+        auto alpha = ALPHA_MULTIPLY(span->coverage, opacity);
+        for (uint32_t x = 0; x < span->len; ++x, ++dst, ++col) {
+            if (*col < 0) continue;
+            auto src = ALPHA_BLEND(image->data[offset + *col], alpha);
+            *dst = src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(src));
+        }
+    }
+    return true;
+}
+
+
+static bool _rasterTranslucentImageRle(SwSurface* surface, const SwRleData* rle, const SwImage* image, uint32_t opacity, const Matrix* invTransform)
 {
     auto span = rle->spans;
 
@@ -334,8 +418,8 @@ static bool _rasterTranslucentImageRle(SwSurface* surface, const SwRleData* rle,
         for (uint32_t x = 0; x < span->len; ++x, ++dst) {
             auto rX = static_cast<uint32_t>(roundf((span->x + x) * invTransform->e11 + ey1));
             auto rY = static_cast<uint32_t>(roundf((span->x + x) * invTransform->e21 + ey2));
-            if (rX >= w || rY >= h) continue;
-            auto src = ALPHA_BLEND(img[rY * w + rX], alpha);     //TODO: need to use image's stride
+            if (rX >= image->w || rY >= image->h) continue;
+            auto src = ALPHA_BLEND(image->data[rY * image->stride + rX], alpha);
             *dst = src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(src));
         }
     }
@@ -343,23 +427,48 @@ static bool _rasterTranslucentImageRle(SwSurface* surface, const SwRleData* rle,
 }
 
 
-static bool _rasterImageRle(SwSurface* surface, SwRleData* rle, uint32_t *img, uint32_t w, uint32_t h)
+static bool _rasterImageRle(SwSurface* surface, SwRleData* rle, const SwImage* image, int32_t tx, int32_t ty)
 {
     auto span = rle->spans;
 
     for (uint32_t i = 0; i < rle->size; ++i, ++span) {
         auto dst = &surface->buffer[span->y * surface->stride + span->x];
-        auto src = img + span->x + span->y * w;    //TODO: need to use image's stride
-        for (uint32_t x = 0; x < span->len; ++x, ++dst, ++src) {
-            *src = ALPHA_BLEND(*src, span->coverage);
-            *dst = *src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(*src));
+        auto src = image->data + (span->x - tx) + (span->y - ty) * image->stride;
+        if (span->coverage == 255) {
+            for (uint32_t x = 0; x < span->len; ++x, ++dst, ++src) {
+                *dst = *src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(*src));
+            }
+        } else {
+            for (uint32_t x = 0; x < span->len; ++x, ++dst, ++src) {
+                auto tmp = ALPHA_BLEND(*src, span->coverage);
+                *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
+            }
         }
     }
     return true;
 }
 
 
-static bool _rasterImageRle(SwSurface* surface, SwRleData* rle, uint32_t *img, uint32_t w, uint32_t h, const Matrix* invTransform)
+static bool _rasterImageRle(SwSurface* surface, SwRleData* rle, const SwImage* image, const SwBBox& region, const int32_t* cols, const Matrix* invTransform)
+{
+    auto span = rle->spans;
+
+    for (uint32_t i = 0; i < rle->size; ++i, ++span) {
+        uint32_t offset;
+        if (!_mapRow(image, invTransform, span->y, &offset)) continue;
+        auto dst = &surface->buffer[span->y * surface->stride + span->x];
+        auto col = cols + (span->x - region.min.x);
+        for (uint32_t x = 0; x < span->len; ++x, ++dst, ++col) {
+            if (*col < 0) continue;
+            auto src = ALPHA_BLEND(image->data[offset + *col], span->coverage);
+            *dst = src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(src));
+        }
+    }
+    return true;
+}
+
+
+static bool _rasterImageRle(SwSurface* surface, SwRleData* rle, const SwImage* image, const Matrix* invTransform)
 {
     auto span = rle->spans;
 
@@ -370,8 +479,8 @@ static bool _rasterImageRle(SwSurface* surface, SwRleData* rle, uint32_t *img, u
         for (uint32_t x = 0; x < span->len; ++x, ++dst) {
             auto rX = static_cast<uint32_t>(roundf((span->x + x) * invTransform->e11 + ey1));
             auto rY = static_cast<uint32_t>(roundf((span->x + x) * invTransform->e21 + ey2));
-            if (rX >= w || rY >= h) continue;
-            auto src = ALPHA_BLEND(img[rY * w + rX], span->coverage);    //TODO: need to use image's stride
+            if (rX >= image->w || rY >= image->h) continue;
+            auto src = ALPHA_BLEND(image->data[rY * image->stride + rX], span->coverage);
             *dst = src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(src));
         }
     }
@@ -379,7 +488,7 @@ static bool _rasterImageRle(SwSurface* surface, SwRleData* rle, uint32_t *img, u
 }
 
 
-static bool _translucentImage(SwSurface* surface, const uint32_t *img, uint32_t w, TVG_UNUSED uint32_t h, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
+static bool _translucentImage(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
 {
     auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
 
@@ -390,8 +499,8 @@ static bool _translucentImage(SwSurface* surface, const uint32_t *img, uint32_t
         for (auto x = region.min.x; x < region.max.x; ++x, ++dst) {
             auto rX = static_cast<uint32_t>(roundf(x * invTransform->e11 + ey1));
             auto rY = static_cast<uint32_t>(roundf(x * invTransform->e21 + ey2));
-            if (rX >= w || rY >= h) continue;
-            auto src = ALPHA_BLEND(img[rX + (rY * w)], opacity);    //TODO: need to use image's stride
+            if (rX >= image->w || rY >= image->h) continue;
+            auto src = ALPHA_BLEND(image->data[rX + (rY * image->stride)], opacity);
             *dst = src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(src));
         }
         dbuffer += surface->stride;
@@ -400,7 +509,7 @@ static bool _translucentImage(SwSurface* surface, const uint32_t *img, uint32_t
 }
 
 
-static bool _translucentImageAlphaMask(SwSurface* surface, const uint32_t *img, uint32_t w, TVG_UNUSED uint32_t h, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
+static bool _translucentImageAlphaMask(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
 {
 #ifdef THORVG_LOG_ENABLED
     cout <<"SW_ENGINE: Transformed Image Alpha Mask Composition" << endl;
@@ -416,8 +525,8 @@ static bool _translucentImageAlphaMask(SwSurface* surface, const uint32_t *img,
         for (auto x = region.min.x; x < region.max.x; ++x, ++dst, ++cmp) {
             auto rX = static_cast<uint32_t>(roundf(x * invTransform->e11 + ey1));
             auto rY = static_cast<uint32_t>(roundf(x * invTransform->e21 + ey2));
-            if (rX >= w || rY >= h) continue;
-            auto tmp = ALPHA_BLEND(img[rX + (rY * w)], ALPHA_MULTIPLY(opacity, surface->blender.alpha(*cmp)));  //TODO: need to use image's stride
+            if (rX >= image->w || rY >= image->h) continue;
+            auto tmp = ALPHA_BLEND(image->data[rX + (rY * image->stride)], ALPHA_MULTIPLY(opacity, surface->blender.alpha(*cmp)));
             *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
         }
         dbuffer += surface->stride;
@@ -426,7 +535,7 @@ static bool _translucentImageAlphaMask(SwSurface* surface, const uint32_t *img,
     return true;
 }
 
-static bool _translucentImageInvAlphaMask(SwSurface* surface, const uint32_t *img, uint32_t w, uint32_t h, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
+static bool _translucentImageInvAlphaMask(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
 {
 #ifdef THORVG_LOG_ENABLED
     cout <<"SW_ENGINE: Transformed Image Inverse Alpha Mask Composition" << endl;
@@ -442,8 +551,8 @@ static bool _translucentImageInvAlphaMask(SwSurface* surface, const uint32_t *im
         for (auto x = region.min.x; x < region.max.x; ++x, ++dst, ++cmp) {
             auto rX = static_cast<uint32_t>(roundf(x * invTransform->e11 + ey1));
             auto rY = static_cast<uint32_t>(roundf(x * invTransform->e21 + ey2));
-            if (rX >= w || rY >= h) continue;
-            auto tmp = ALPHA_BLEND(img[rX + (rY * w)], ALPHA_MULTIPLY(opacity, 255 - surface->blender.alpha(*cmp)));  //TODO: need to use image's stride
+            if (rX >= image->w || rY >= image->h) continue;
+            auto tmp = ALPHA_BLEND(image->data[rX + (rY * image->stride)], ALPHA_MULTIPLY(opacity, 255 - surface->blender.alpha(*cmp)));
             *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
         }
         dbuffer += surface->stride;
@@ -452,24 +561,105 @@ static bool _translucentImageInvAlphaMask(SwSurface* surface, const uint32_t *im
     return true;
 }
 
-static bool _rasterTranslucentImage(SwSurface* surface, const uint32_t *img, uint32_t w, uint32_t h, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
+static bool _rasterTranslucentImage(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
+{
+    if (surface->compositor) {
+        if (surface->compositor->method == CompositeMethod::AlphaMask) {
+            return _translucentImageAlphaMask(surface, image, opacity, region, invTransform);
+        }
+        if (surface->compositor->method == CompositeMethod::InvAlphaMask) {
+            return _translucentImageInvAlphaMask(surface, image, opacity, region, invTransform);
+        }
+    }
+    return _translucentImage(surface, image, opacity, region, invTransform);
+}
+
+
+static bool _translucentImage(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, const int32_t* cols, const Matrix* invTransform)
+{
+    auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
+
+    for (auto y = region.min.y; y < region.max.y; ++y, dbuffer += surface->stride) {
+        uint32_t offset;
+        if (!_mapRow(image, invTransform, y, &offset)) continue;
+        auto dst = dbuffer;
+        auto col = cols;
+        for (auto x = region.min.x; x < region.max.x; ++x, ++dst, ++col) {
+            if (*col < 0) continue;
+            auto src = ALPHA_BLEND(image->data[offset + *col], opacity);
+            *dst = src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(src));
+        }
+    }
+    return true;
+}
+
+
+static bool _translucentImageAlphaMask(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, const int32_t* cols, const Matrix* invTransform)
+{
+#ifdef THORVG_LOG_ENABLED
+    cout <<"SW_ENGINE: Scaled Image Alpha Mask Composition" << endl;
+#endif
+    auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
+    auto cbuffer = &surface->compositor->image.data[region.min.y * surface->stride + region.min.x];
+
+    for (auto y = region.min.y; y < region.max.y; ++y, dbuffer += surface->stride, cbuffer += surface->stride) {
+        uint32_t offset;
+        if (!_mapRow(image, invTransform, y, &offset)) continue;
+        auto dst = dbuffer;
+        auto cmp = cbuffer;
+        auto col = cols;
+        for (auto x = region.min.x; x < region.max.x; ++x, ++dst, ++cmp, ++col) {
+            if (*col < 0) continue;
+            auto tmp = ALPHA_BLEND(image->data[offset + *col], ALPHA_MULTIPLY(opacity, surface->blender.alpha(*cmp)));
+            *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
+        }
+    }
+    return true;
+}
+
+
+static bool _translucentImageInvAlphaMask(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, const int32_t* cols, const Matrix* invTransform)
+{
+#ifdef THORVG_LOG_ENABLED
+    cout <<"SW_ENGINE: Scaled Image Inverse Alpha Mask Composition" << endl;
+#endif
+    auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
+    auto cbuffer = &surface->compositor->image.data[region.min.y * surface->stride + region.min.x];
+
+    for (auto y = region.min.y; y < region.max.y; ++y, dbuffer += surface->stride, cbuffer += surface->stride) {
+        uint32_t offset;
+        if (!_mapRow(image, invTransform, y, &offset)) continue;
+        auto dst = dbuffer;
+        auto cmp = cbuffer;
+        auto col = cols;
+        for (auto x = region.min.x; x < region.max.x; ++x, ++dst, ++cmp, ++col) {
+            if (*col < 0) continue;
+            auto tmp = ALPHA_BLEND(image->data[offset + *col], ALPHA_MULTIPLY(opacity, 255 - surface->blender.alpha(*cmp)));
+            *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
+        }
+    }
+    return true;
+}
+
+
+static bool _rasterTranslucentImage(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, const int32_t* cols, const Matrix* invTransform)
 {
     if (surface->compositor) {
         if (surface->compositor->method == CompositeMethod::AlphaMask) {
-            return _translucentImageAlphaMask(surface, img, w, h, opacity, region, invTransform);
+            return _translucentImageAlphaMask(surface, image, opacity, region, cols, invTransform);
         }
         if (surface->compositor->method == CompositeMethod::InvAlphaMask) {
-            return _translucentImageInvAlphaMask(surface, img, w, h, opacity, region, invTransform);
+            return _translucentImageInvAlphaMask(surface, image, opacity, region, cols, invTransform);
         }
     }
-    return _translucentImage(surface, img, w, h, opacity, region, invTransform);
+    return _translucentImage(surface, image, opacity, region, cols, invTransform);
 }
 
 
-static bool _translucentImage(SwSurface* surface, uint32_t *img, uint32_t w, uint32_t h, uint32_t opacity, const SwBBox& region)
+static bool _translucentImage(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, int32_t tx, int32_t ty)
 {
     auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
-    auto sbuffer = img + region.min.x + region.min.y * w;    //TODO: need to use image's stride
+    auto sbuffer = image->data + (region.min.x - tx) + (region.min.y - ty) * image->stride;
 
     for (auto y = region.min.y; y < region.max.y; ++y) {
         auto dst = dbuffer;
@@ -479,13 +669,13 @@ static bool _translucentImage(SwSurface* surface, uint32_t *img, uint32_t w, uin
             *dst = p + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(p));
         }
         dbuffer += surface->stride;
-        sbuffer += w;    //TODO: need to use image's stride
+        sbuffer += image->stride;
     }
     return true;
 }
 
 
-static bool _translucentImageAlphaMask(SwSurface* surface, uint32_t *img, uint32_t w, uint32_t h, uint32_t opacity, const SwBBox& region)
+static bool _translucentImageAlphaMask(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, int32_t tx, int32_t ty)
 {
     auto buffer = surface->buffer + (region.min.y * surface->stride) + region.min.x;
     auto h2 = static_cast<uint32_t>(region.max.y - region.min.y);
@@ -495,7 +685,7 @@ static bool _translucentImageAlphaMask(SwSurface* surface, uint32_t *img, uint32
     cout <<"SW_ENGINE: Image Alpha Mask Composition" << endl;
 #endif
 
-    auto sbuffer = img + (region.min.y * w) + region.min.x;
+    auto sbuffer = image->data + ((region.min.y - ty) * image->stride) + (region.min.x - tx);
     auto cbuffer = surface->compositor->image.data + (region.min.y * surface->stride) + region.min.x;   //compositor buffer
 
     for (uint32_t y = 0; y < h2; ++y) {
@@ -508,13 +698,13 @@ static bool _translucentImageAlphaMask(SwSurface* surface, uint32_t *img, uint32
         }
         buffer += surface->stride;
         cbuffer += surface->stride;
-        sbuffer += w;   //TODO: need to use image's stride
+        sbuffer += image->stride;
     }
     return true;
 }
 
 
-static bool _translucentImageInvAlphaMask(SwSurface* surface, uint32_t *img, uint32_t w, uint32_t h, uint32_t opacity, const SwBBox& region)
+static bool _translucentImageInvAlphaMask(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, int32_t tx, int32_t ty)
 {
     auto buffer = surface->buffer + (region.min.y * surface->stride) + region.min.x;
     auto h2 = static_cast<uint32_t>(region.max.y - region.min.y);
@@ -524,7 +714,7 @@ static bool _translucentImageInvAlphaMask(SwSurface* surface, uint32_t *img, uin
     cout <<"SW_ENGINE: Image Inverse Alpha Mask Composition" << endl;
 #endif
 
-    auto sbuffer = img + (region.min.y * w) + region.min.x;
+    auto sbuffer = image->data + ((region.min.y - ty) * image->stride) + (region.min.x - tx);
     auto cbuffer = surface->compositor->image.data + (region.min.y * surface->stride) + region.min.x;   //compositor buffer
 
     for (uint32_t y = 0; y < h2; ++y) {
@@ -537,29 +727,29 @@ static bool _translucentImageInvAlphaMask(SwSurface* surface, uint32_t *img, uin
         }
         buffer += surface->stride;
         cbuffer += surface->stride;
-        sbuffer += w;   //TODO: need to use image's stride
+        sbuffer += image->stride;
     }
     return true;
 }
 
-static bool _rasterTranslucentImage(SwSurface* surface, uint32_t *img, uint32_t w, uint32_t h, uint32_t opacity, const SwBBox& region)
+static bool _rasterTranslucentImage(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, int32_t tx, int32_t ty)
 {
     if (surface->compositor) {
         if (surface->compositor->method == CompositeMethod::AlphaMask) {
-            return _translucentImageAlphaMask(surface, img, w, h, opacity, region);
+            return _translucentImageAlphaMask(surface, image, opacity, region, tx, ty);
         }
         if (surface->compositor->method == CompositeMethod::InvAlphaMask) {
-            return _translucentImageInvAlphaMask(surface, img, w, h, opacity, region);
+            return _translucentImageInvAlphaMask(surface, image, opacity, region, tx, ty);
         }
     }
-    return _translucentImage(surface, img, w, h, opacity, region);
+    return _translucentImage(surface, image, opacity, region, tx, ty);
 }
 
 
-static bool _rasterImage(SwSurface* surface, uint32_t *img, uint32_t w, TVG_UNUSED uint32_t h, const SwBBox& region)
+static bool _rasterImage(SwSurface* surface, const SwImage* image, const SwBBox& region, int32_t tx, int32_t ty)
 {
     auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
-    auto sbuffer = img + region.min.x + region.min.y * w;   //TODO: need to use image's stride
+    auto sbuffer = image->data + (region.min.x - tx) + (region.min.y - ty) * image->stride;
 
     for (auto y = region.min.y; y < region.max.y; ++y) {
         auto dst = dbuffer;
@@ -568,13 +758,32 @@ static bool _rasterImage(SwSurface* surface, uint32_t *img, uint32_t w, TVG_UNUS
             *dst = *src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(*src));
         }
         dbuffer += surface->stride;
-        sbuffer += w;    //TODO: need to use image's stride
+        sbuffer += image->stride;
     }
     return true;
 }
 
 
-static bool _rasterImage(SwSurface* surface, const uint32_t *img, uint32_t w, uint32_t h, const SwBBox& region, const Matrix* invTransform)
+static bool _rasterImage(SwSurface* surface, const SwImage* image, const SwBBox& region, const int32_t* cols, const Matrix* invTransform)
+{
+    auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
+
+    for (auto y = region.min.y; y < region.max.y; ++y, dbuffer += surface->stride) {
+        uint32_t offset;
+        if (!_mapRow(image, invTransform, y, &offset)) continue;
+        auto dst = dbuffer;
+        auto col = cols;
+        for (auto x = region.min.x; x < region.max.x; ++x, ++dst, ++col) {
+            if (*col < 0) continue;
+            auto src = image->data[offset + *col];
+            *dst = src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(src));
+        }
+    }
+    return true;
+}
+
+
+static bool _rasterImage(SwSurface* surface, const SwImage* image, const SwBBox& region, const Matrix* invTransform)
 {
     for (auto y = region.min.y; y < region.max.y; ++y) {
         auto dst = &surface->buffer[y * surface->stride + region.min.x];
@@ -583,8 +792,8 @@ static bool _rasterImage(SwSurface* surface, const uint32_t *img, uint32_t w, ui
         for (auto x = region.min.x; x < region.max.x; ++x, ++dst) {
             auto rX = static_cast<uint32_t>(roundf(x * invTransform->e11 + ey1));
             auto rY = static_cast<uint32_t>(roundf(x * invTransform->e21 + ey2));
-            if (rX >= w || rY >= h) continue;
-            auto src = img[rX + (rY * w)];    //TODO: need to use image's stride
+            if (rX >= image->w || rY >= image->h) continue;
+            auto src = image->data[rX + (rY * image->stride)];
             *dst = src + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(src));
         }
     }
@@ -592,6 +801,157 @@ static bool _rasterImage(SwSurface* surface, const uint32_t *img, uint32_t w, ui
 }
 
 
+/* Expand the compact (A8, L8, RGB565) pixels of a row into the 32-bit premultiplied colors
+   of the target colorspace. Out of the image boundary is filled with the transparent color. */
+static void _fetchRow(const SwSurface* surface, const SwImage* image, const Matrix* invTransform, SwCoord x, SwCoord y, uint32_t len, uint32_t* dst)
+{
+    auto ey1 = y * invTransform->e12 + invTransform->e13;
+    auto ey2 = y * invTransform->e22 + invTransform->e23;
+    auto tint = surface->blender.join(image->tint[0], image->tint[1], image->tint[2], 255);
+
+    for (uint32_t i = 0; i < len; ++i, ++x, ++dst) {
+        auto rX = static_cast<uint32_t>(roundf(x * invTransform->e11 + ey1));
+        auto rY = static_cast<uint32_t>(roundf(x * invTransform->e21 + ey2));
+        if (rX >= image->w || rY >= image->h) {
+            *dst = 0;
+            continue;
+        }
+        auto offset = rY * image->stride + rX;
+        switch (image->format) {
+            case Picture::A8: {
+                *dst = ALPHA_BLEND(tint, image->data8[offset]);
+                break;
+            }
+            case Picture::L8: {
+                auto l = image->data8[offset];
+                *dst = surface->blender.join(l, l, l, 255);
+                break;
+            }
+            default: {
+                auto c = image->data16[offset];
+                auto r = (c >> 11) & 0x1f;
+                auto g = (c >> 5) & 0x3f;
+                auto b = c & 0x1f;
+                *dst = surface->blender.join((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255);
+                break;
+            }
+        }
+    }
+}
+
+
+static bool _rasterCompactImageRle(SwSurface* surface, const SwRleData* rle, const SwImage* image, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
+{
+    auto len = region.max.x - region.min.x;
+    if (len <= 0) return false;
+    auto buffer = static_cast<uint32_t*>(alloca(len * sizeof(uint32_t)));
+    if (!buffer) return false;
+
+    auto span = rle->spans;
+
+    for (uint32_t i = 0; i < rle->size; ++i, ++span) {
+        auto dst = &surface->buffer[span->y * surface->stride + span->x];
+        auto alpha = ALPHA_MULTIPLY(span->coverage, opacity);
+        auto spanLen = min(static_cast<uint32_t>(span->len), static_cast<uint32_t>(len));
+        _fetchRow(surface, image, invTransform, span->x, span->y, spanLen, buffer);
+        auto src = buffer;
+        for (uint32_t x = 0; x < spanLen; ++x, ++dst, ++src) {
+            auto tmp = ALPHA_BLEND(*src, alpha);
+            *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
+        }
+    }
+    return true;
+}
+
+
+static bool _compactImage(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, uint32_t* buffer, const Matrix* invTransform)
+{
+    auto len = region.max.x - region.min.x;
+    auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
+
+    for (auto y = region.min.y; y < region.max.y; ++y) {
+        _fetchRow(surface, image, invTransform, region.min.x, y, len, buffer);
+        auto dst = dbuffer;
+        auto src = buffer;
+        for (auto x = 0; x < len; ++x, ++dst, ++src) {
+            auto tmp = ALPHA_BLEND(*src, opacity);
+            *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
+        }
+        dbuffer += surface->stride;
+    }
+    return true;
+}
+
+
+static bool _compactImageAlphaMask(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, uint32_t* buffer, const Matrix* invTransform)
+{
+#ifdef THORVG_LOG_ENABLED
+    cout <<"SW_ENGINE: Compact Image Alpha Mask Composition" << endl;
+#endif
+    auto len = region.max.x - region.min.x;
+    auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
+    auto cbuffer = &surface->compositor->image.data[region.min.y * surface->stride + region.min.x];
+
+    for (auto y = region.min.y; y < region.max.y; ++y) {
+        _fetchRow(surface, image, invTransform, region.min.x, y, len, buffer);
+        auto dst = dbuffer;
+        auto cmp = cbuffer;
+        auto src = buffer;
+        for (auto x = 0; x < len; ++x, ++dst, ++cmp, ++src) {
+            auto tmp = ALPHA_BLEND(*src, ALPHA_MULTIPLY(opacity, surface->blender.alpha(*cmp)));
+            *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
+        }
+        dbuffer += surface->stride;
+        cbuffer += surface->stride;
+    }
+    return true;
+}
+
+
+static bool _compactImageInvAlphaMask(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, uint32_t* buffer, const Matrix* invTransform)
+{
+#ifdef THORVG_LOG_ENABLED
+    cout <<"SW_ENGINE: Compact Image Inverse Alpha Mask Composition" << endl;
+#endif
+    auto len = region.max.x - region.min.x;
+    auto dbuffer = &surface->buffer[region.min.y * surface->stride + region.min.x];
+    auto cbuffer = &surface->compositor->image.data[region.min.y * surface->stride + region.min.x];
+
+    for (auto y = region.min.y; y < region.max.y; ++y) {
+        _fetchRow(surface, image, invTransform, region.min.x, y, len, buffer);
+        auto dst = dbuffer;
+        auto cmp = cbuffer;
+        auto src = buffer;
+        for (auto x = 0; x < len; ++x, ++dst, ++cmp, ++src) {
+            auto tmp = ALPHA_BLEND(*src, ALPHA_MULTIPLY(opacity, 255 - surface->blender.alpha(*cmp)));
+            *dst = tmp + ALPHA_BLEND(*dst, 255 - surface->blender.alpha(tmp));
+        }
+        dbuffer += surface->stride;
+        cbuffer += surface->stride;
+    }
+    return true;
+}
+
+
+static bool _rasterCompactImage(SwSurface* surface, const SwImage* image, uint32_t opacity, const SwBBox& region, const Matrix* invTransform)
+{
+    auto len = region.max.x - region.min.x;
+    if (len <= 0) return false;
+    auto buffer = static_cast<uint32_t*>(alloca(len * sizeof(uint32_t)));
+    if (!buffer) return false;
+
+    if (surface->compositor) {
+        if (surface->compositor->method == CompositeMethod::AlphaMask) {
+            return _compactImageAlphaMask(surface, image, opacity, region, buffer, invTransform);
+        }
+        if (surface->compositor->method == CompositeMethod::InvAlphaMask) {
+            return _compactImageInvAlphaMask(surface, image, opacity, region, buffer, invTransform);
+        }
+    }
+    return _compactImage(surface, image, opacity, region, buffer, invTransform);
+}
+
+
 /************************************************************************/
 /* Gradient                                                             */
 /************************************************************************/
@@ -1199,6 +1559,8 @@ bool rasterClear(SwSurface* surface)
 
 bool rasterImage(SwSurface* surface, SwImage* image, const Matrix* transform, const SwBBox& bbox, uint32_t opacity)
 {
+    if (!image->data) return false;
+
     Matrix invTransform;
 
     if (transform) {
@@ -1206,28 +1568,52 @@ bool rasterImage(SwSurface* surface, SwImage* image, const Matrix* transform, co
     }
     else invTransform = {1, 0, 0, 0, 1, 0, 0, 0, 1};
 
+    //Compact pixels are expanded to the 32-bit colors row by row.
+    if (image->format != Picture::Color32) {
+        if (image->rle) return _rasterCompactImageRle(surface, image->rle, image, opacity, bbox, &invTransform);
+        return _rasterCompactImage(surface, image, opacity, bbox, &invTransform);
+    }
+
     auto translucent = _translucent(surface, opacity);
 
-    if (image->rle) {
-        //Fast track
-        if (_identify(transform)) {
-            //OPTIMIZE ME: Support non transformed image. Only shifted image can use these routines.
-            if (translucent) return _rasterTranslucentImageRle(surface, image->rle, image->data, image->w, image->h, opacity);
-            return _rasterImageRle(surface, image->rle, image->data, image->w, image->h);
-        } else {
-            if (translucent) return _rasterTranslucentImageRle(surface, image->rle, image->data, image->w, image->h, opacity, &invTransform);
-            return _rasterImageRle(surface, image->rle, image->data, image->w, image->h, &invTransform);
+    //Fast track: Non-transformed or pixel aligned shifted image
+    int32_t tx, ty;
+    if (_translation(transform, &tx, &ty)) {
+        if (image->rle) {
+            if (translucent) return _rasterTranslucentImageRle(surface, image->rle, image, opacity, tx, ty);
+            return _rasterImageRle(surface, image->rle, image, tx, ty);
         }
+        //Source pixels are accessed directly, keep the region inside of the image.
+        SwBBox region;
+        region.min.x = max(bbox.min.x, static_cast<SwCoord>(tx));
+        region.min.y = max(bbox.min.y, static_cast<SwCoord>(ty));
+        region.max.x = min(bbox.max.x, static_cast<SwCoord>(tx + image->w));
+        region.max.y = min(bbox.max.y, static_cast<SwCoord>(ty + image->h));
+        if (region.max.x <= region.min.x || region.max.y <= region.min.y) return false;
+
+        if (translucent) return _rasterTranslucentImage(surface, image, opacity, region, tx, ty);
+        return _rasterImage(surface, image, region, tx, ty);
     }
-    else {
-        //Fast track
-        if (_identify(transform)) {
-            //OPTIMIZE ME: Support non transformed image. Only shifted image can use these routines.
-            if (translucent) return _rasterTranslucentImage(surface, image->data, image->w, image->h, opacity, bbox);
-            else return _rasterImage(surface, image->data, image->w, image->h, bbox);
-        } else {
-            if (translucent) return _rasterTranslucentImage(surface, image->data, image->w, image->h, opacity, bbox, &invTransform);
-            else return _rasterImage(surface, image->data, image->w, image->h, bbox, &invTransform);
+
+    //Fast track: Scaled, flipped or 90 degree rotated image. Columns are mapped once for the every rows.
+    if (_axisAligned(&invTransform, bbox)) {
+        auto len = bbox.max.x - bbox.min.x;
+        if (len <= 0) return false;
+        auto cols = static_cast<int32_t*>(alloca(len * sizeof(int32_t)));
+        _mapColumns(image, &invTransform, bbox.min.x, len, cols);
+
+        if (image->rle) {
+            if (translucent) return _rasterTranslucentImageRle(surface, image->rle, image, opacity, bbox, cols, &invTransform);
+            return _rasterImageRle(surface, image->rle, image, bbox, cols, &invTransform);
         }
+        if (translucent) return _rasterTranslucentImage(surface, image, opacity, bbox, cols, &invTransform);
+        return _rasterImage(surface, image, bbox, cols, &invTransform);
+    }
+
+    if (image->rle) {
+        if (translucent) return _rasterTranslucentImageRle(surface, image->rle, image, opacity, &invTransform);
+        return _rasterImageRle(surface, image->rle, image, &invTransform);
     }
+    if (translucent) return _rasterTranslucentImage(surface, image, opacity, bbox, &invTransform);
+    return _rasterImage(surface, image, bbox, &invTransform);
 }
@@ -169,23 +169,32 @@ struct SwShapeTask : SwTask
 struct SwImageTask : SwTask
 {
     SwImage image;
-    const Picture* pdata = nullptr;
+    const RenderImage* source = nullptr;     //Image source
 
     void run(unsigned tid) override
     {
         auto clipRegion = bbox;
 
+        image.data = source->buffer;
+        image.w = source->w;
+        image.h = source->h;
+        image.stride = source->stride;
+        image.format = source->format;
+        image.tint[0] = source->tint[0];
+        image.tint[1] = source->tint[1];
+        image.tint[2] = source->tint[2];
+
         //Invisible shape turned to visible by alpha.
         auto prepareImage = false;
         if (!imagePrepared(&image) && ((flags & RenderUpdateFlag::Image) || (opacity > 0))) prepareImage = true;
 
         if (prepareImage) {
             imageReset(&image);
-            if (!imagePrepare(&image, pdata, transform, clipRegion, bbox, mpool, tid)) goto end;
+            if (!imagePrepare(&image, transform, clipRegion, bbox, mpool, tid)) goto end;
 
             //Clip Path?
             if (clips.count > 0) {
-                if (!imageGenRle(&image, pdata, bbox, false)) goto end;
+                if (!imageGenRle(&image, bbox, false)) goto end;
                 if (image.rle) {
                     for (auto clip = clips.data; clip < (clips.data + clips.count); ++clip) {
                         auto clipper = &static_cast<SwShapeTask*>(*clip)->shape;
@@ -195,7 +204,6 @@ struct SwImageTask : SwTask
                 }
             }
         }
-        image.data = const_cast<uint32_t*>(pdata->data());
     end:
         imageDelOutline(&image, mpool, tid);
     }
@@ -271,6 +279,13 @@ bool SwRenderer::viewport(const RenderRegion& vp)
 }
 
 
+uint32_t SwRenderer::colorSpace()
+{
+    if (surface) return surface->cs;
+    return SwCanvas::ARGB8888;
+}
+
+
 bool SwRenderer::target(uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t h, uint32_t cs)
 {
     if (!buffer || stride == 0 || w == 0 || h == 0 || w > stride) return false;
@@ -476,6 +491,7 @@ Compositor* SwRenderer::target(const RenderRegion& region)
     cmp->compositor->bbox.max.y = y + h;
     cmp->compositor->image.w = surface->stride;
     cmp->compositor->image.h = surface->h;
+    cmp->compositor->image.stride = surface->stride;
 
     //We know partial clear region
     cmp->buffer = cmp->compositor->image.data + (cmp->stride * y + x);
@@ -531,6 +547,14 @@ bool SwRenderer::dispose(RenderData data)
 
     task->done();
     task->dispose();
+
+    //The prepared task may be disposed before the rendering, the clear() must not wait for it.
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < tasks.count; ++i) {
+        if (tasks.data[i] != task) tasks.data[n++] = tasks.data[i];
+    }
+    tasks.count = n;
+
     if (task->transform) free(task->transform);
     delete(task);
 
@@ -578,14 +602,14 @@ void* SwRenderer::prepareCommon(SwTask* task, const RenderTransform* transform,
 }
 
 
-RenderData SwRenderer::prepare(const Picture& pdata, RenderData data, const RenderTransform* transform, uint32_t opacity, Array<RenderData>& clips, RenderUpdateFlag flags)
+RenderData SwRenderer::prepare(RenderImage* image, RenderData data, const RenderTransform* transform, uint32_t opacity, Array<RenderData>& clips, RenderUpdateFlag flags)
 {
     //prepare task
     auto task = static_cast<SwImageTask*>(data);
     if (!task) {
         task = new SwImageTask;
         if (!task) return nullptr;
-        task->pdata = &pdata;
+        task->source = image;
     }
     return prepareCommon(task, transform, opacity, clips, flags);
 }
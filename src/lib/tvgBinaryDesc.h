@@ -52,15 +52,25 @@ struct tvgBlock
 #else
     #define TVG_BIN_HEADER_SIGNATURE "TVG"
     #define TVG_BIN_HEADER_SIGNATURE_LENGTH 3
-    #define TVG_BIN_HEADER_VERSION "000"
+    /* 000: the raw paths. The scene index (0x31) is written within it, the older loaders skip it as an unknown block.
+       001: the fixed-point paths.
+       002: the paint blocks compressed as a whole (0x80). */
+    #define TVG_BIN_HEADER_VERSION "002"
     #define TVG_BIN_HEADER_VERSION_LENGTH 3
     #define TVG_BIN_HEADER_DATA_LENGTH 2
 #endif
 
+//Header meta data for the view box of the content: vx, vy, vw, vh, w, h and the preserve aspect flag.
+#define TVG_BIN_HEADER_META_VIEWBOX_LENGTH (6 * sizeof(float) + 1)
+
 #define TVG_PICTURE_BEGIN_INDICATOR   (TvgIndicator)0xfc
 #define TVG_SHAPE_BEGIN_INDICATOR     (TvgIndicator)0xfd
 #define TVG_SCENE_BEGIN_INDICATOR     (TvgIndicator)0xfe
 
+/* A paint block compressed as a whole, standing in for it: the indicator and the length of the paint,
+   and its data in the LZ4 block format. */
+#define TVG_COMPRESSED_BLOCK_INDICATOR (TvgIndicator)0x80
+
 // Paint
 #define TVG_PAINT_OPACITY_INDICATOR          (TvgIndicator)0x10
 #define TVG_PAINT_TRANSFORM_MATRIX_INDICATOR (TvgIndicator)0x11
@@ -73,6 +83,7 @@ struct tvgBlock
 
 // Scene
 #define TVG_SCENE_FLAG_RESERVEDCNT           (TvgIndicator)0x30
+#define TVG_SCENE_INDEX_INDICATOR            (TvgIndicator)0x31    //uint32 offsets of the children from the scene data, ahead of them
 
 // Shape
 #define TVG_SHAPE_PATH_INDICATOR    (TvgIndicator)0x40
@@ -84,6 +95,19 @@ struct tvgBlock
 #define TVG_SHAPE_FILLRULE_WINDING_FLAG      (TvgFlag)0x00
 #define TVG_SHAPE_FILLRULE_EVENODD_FLAG      (TvgFlag)0x01
 
+/* The path in the fixed-point coordinates of the declared decimal precision:
+   varint command count, varint point count, precision digits, 2-bit commands,
+   and zigzag varint deltas of the points from the previous ones. */
+#define TVG_SHAPE_QUANTIZED_PATH_INDICATOR (TvgIndicator)0x45
+#define TVG_SHAPE_PATH_PRECISION_MAX 6
+
+static const double _tvgPathScales[TVG_SHAPE_PATH_PRECISION_MAX + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+static inline float _tvgDequantize(int64_t value, uint8_t precision)
+{
+    return static_cast<float>(value / _tvgPathScales[precision]);
+}
+
 #define TVG_SHAPE_STROKE_CAP_INDICATOR  (TvgIndicator)0x50
 #define TVG_SHAPE_STROKE_CAP_SQUARE_FLAG     (TvgFlag)0x00
 #define TVG_SHAPE_STROKE_CAP_ROUND_FLAG      (TvgFlag)0x01
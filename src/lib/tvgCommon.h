@@ -36,6 +36,21 @@ using namespace tvg;
 #define TVG_CLASS_ID_LINEAR    4
 #define TVG_CLASS_ID_RADIAL    5
 
+//The implementation of the instance, reached inside the library only
+namespace tvg
+{
+    struct Accessor
+    {
+        template<typename T>
+        static auto impl(const T* instance) -> decltype(instance->pImpl)
+        {
+            return instance->pImpl;
+        }
+    };
+}
+
+#define P(A) (Accessor::impl(A))
+
 //for MSVC Compat
 #ifdef _MSC_VER
     #define TVG_UNUSED
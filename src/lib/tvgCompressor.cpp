@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2021 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <memory.h>
+#include "tvgCompressor.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_MAX_OFFSET 65535
+#define LZ4_HASH_LOG 12
+#define LZ4_LAST_LITERALS 5     //the block always ends with the literals
+#define LZ4_MATCH_LIMIT 12      //no match starts within the last bytes
+#define LZ4_RUN_MASK 15
+
+static uint32_t _read32(const char* ptr)
+{
+    uint32_t value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+
+static uint32_t _hash(uint32_t value)
+{
+    return (value * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+
+static char* _writeLength(char* dst, uint32_t len)
+{
+    while (len >= 255) {
+        *dst++ = static_cast<char>(255);
+        len -= 255;
+    }
+    *dst++ = static_cast<char>(len);
+    return dst;
+}
+
+
+static bool _readLength(const char** ptr, const char* end, uint32_t limit, uint32_t* len)
+{
+    uint8_t byte;
+    do {
+        if (*ptr >= end) return false;
+        byte = static_cast<uint8_t>(*(*ptr)++);
+        *len += byte;
+        if (*len > limit) return false;
+    } while (byte == 255);
+    return true;
+}
+
+
+//The match is omitted for the last literals.
+static char* _writeSequence(char* dst, const char* literals, uint32_t litLen, uint32_t offset, uint32_t matchLen)
+{
+    auto token = dst++;
+    *token = static_cast<char>(((litLen < LZ4_RUN_MASK) ? litLen : LZ4_RUN_MASK) << 4);
+    if (litLen >= LZ4_RUN_MASK) dst = _writeLength(dst, litLen - LZ4_RUN_MASK);
+    memcpy(dst, literals, litLen);
+    dst += litLen;
+
+    if (matchLen == 0) return dst;
+
+    *dst++ = static_cast<char>(offset & 0xff);
+    *dst++ = static_cast<char>(offset >> 8);
+    matchLen -= LZ4_MIN_MATCH;
+    *token |= static_cast<char>((matchLen < LZ4_RUN_MASK) ? matchLen : LZ4_RUN_MASK);
+    if (matchLen >= LZ4_RUN_MASK) dst = _writeLength(dst, matchLen - LZ4_RUN_MASK);
+    return dst;
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+uint32_t tvg::lz4Bound(uint32_t size)
+{
+    return size + size / 255 + 16;
+}
+
+
+//Returns the compressed size, 0 if the capacity is under the bound.
+uint32_t tvg::lz4Compress(const char* src, uint32_t size, char* dst, uint32_t capacity)
+{
+    if (capacity < lz4Bound(size)) return 0;
+
+    //The last positions of the hashed 4 bytes, plus one.
+    uint32_t table[1 << LZ4_HASH_LOG];
+    memset(table, 0, sizeof(table));
+
+    auto ptr = dst;
+    uint32_t anchor = 0;
+
+    if (size > LZ4_MATCH_LIMIT) {
+        auto limit = size - LZ4_MATCH_LIMIT;
+        auto matchEnd = size - LZ4_LAST_LITERALS;
+        uint32_t pos = 0;
+        while (pos < limit) {
+            auto value = _read32(src + pos);
+            auto hash = _hash(value);
+            auto ref = table[hash];
+            table[hash] = pos + 1;
+
+            //Step over the incompressible data faster the longer it goes.
+            if (ref == 0 || pos - (ref - 1) > LZ4_MAX_OFFSET || _read32(src + ref - 1) != value) {
+                pos += 1 + ((pos - anchor) >> 6);
+                continue;
+            }
+            --ref;
+
+            auto len = LZ4_MIN_MATCH;
+            while (pos + len < matchEnd && src[ref + len] == src[pos + len]) ++len;
+
+            ptr = _writeSequence(ptr, src + anchor, pos - anchor, pos - ref, len);
+            pos += len;
+            anchor = pos;
+            if (pos - 2 < limit) table[_hash(_read32(src + pos - 2))] = pos - 1;
+        }
+    }
+
+    ptr = _writeSequence(ptr, src + anchor, size - anchor, 0, 0);
+    return static_cast<uint32_t>(ptr - dst);
+}
+
+
+//The data must fill the destination exactly.
+bool tvg::lz4Decompress(const char* src, uint32_t size, char* dst, uint32_t dstSize)
+{
+    auto end = src + size;
+    auto out = dst;
+    auto outEnd = dst + dstSize;
+
+    while (src < end) {
+        auto token = static_cast<uint8_t>(*src++);
+
+        uint32_t len = token >> 4;
+        if (len == LZ4_RUN_MASK && !_readLength(&src, end, dstSize, &len)) return false;
+        if (len > static_cast<uint32_t>(end - src) || len > static_cast<uint32_t>(outEnd - out)) return false;
+        memcpy(out, src, len);
+        out += len;
+        src += len;
+
+        //The last sequence has no match.
+        if (src == end) break;
+
+        if (end - src < 2) return false;
+        uint32_t offset = static_cast<uint8_t>(src[0]) | (static_cast<uint8_t>(src[1]) << 8);
+        src += 2;
+        if (offset == 0 || offset > static_cast<uint32_t>(out - dst)) return false;
+
+        len = token & LZ4_RUN_MASK;
+        if (len == LZ4_RUN_MASK && !_readLength(&src, end, dstSize, &len)) return false;
+        len += LZ4_MIN_MATCH;
+        if (len > static_cast<uint32_t>(outEnd - out)) return false;
+
+        //The overlapped reference repeats the last bytes, twice as many of them each time.
+        auto ref = out - offset;
+        while (len > 0) {
+            auto cnt = static_cast<uint32_t>(out - ref);
+            if (cnt > len) cnt = len;
+            memcpy(out, ref, cnt);
+            out += cnt;
+            len -= cnt;
+        }
+    }
+    return out == outEnd;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020-2021 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "tvgFileSource.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #define FILE_MAPPING_SUPPORT
+#endif
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+#ifdef FILE_MAPPING_SUPPORT
+static bool _map(const string& path, const char** data, uint32_t* size)
+{
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    auto ret = false;
+    struct stat info;
+
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 && info.st_size <= UINT32_MAX) {
+        auto map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            //Parsers read the contents from the beginning to the end.
+            posix_madvise(map, info.st_size, POSIX_MADV_SEQUENTIAL);
+            *data = static_cast<const char*>(map);
+            *size = static_cast<uint32_t>(info.st_size);
+            ret = true;
+        }
+    }
+
+    //The mapping is kept alive after closing the descriptor.
+    ::close(fd);
+
+    return ret;
+}
+#endif
+
+
+static bool _read(const string& path, const char** data, uint32_t* size)
+{
+    auto file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    auto ret = false;
+    char* buffer = nullptr;
+    long len;
+
+    if (fseek(file, 0, SEEK_END) < 0) goto finalize;
+    if ((len = ftell(file)) < 1 || static_cast<unsigned long>(len) > UINT32_MAX) goto finalize;
+    if (fseek(file, 0, SEEK_SET) < 0) goto finalize;
+
+    buffer = static_cast<char*>(malloc(len));
+    if (!buffer) goto finalize;
+
+    if (fread(buffer, len, 1, file) < 1) {
+        free(buffer);
+        goto finalize;
+    }
+
+    *data = buffer;
+    *size = static_cast<uint32_t>(len);
+    ret = true;
+
+finalize:
+    fclose(file);
+    return ret;
+}
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+FileSource::~FileSource()
+{
+    close();
+}
+
+
+bool FileSource::open(const string& path)
+{
+    close();
+
+#ifdef FILE_MAPPING_SUPPORT
+    if (_map(path, &data, &size)) {
+        mapped = true;
+        return true;
+    }
+#endif
+
+    return _read(path, &data, &size);
+}
+
+
+void FileSource::close()
+{
+    if (!data) return;
+
+#ifdef FILE_MAPPING_SUPPORT
+    if (mapped) munmap(const_cast<char*>(data), size);
+    else free(const_cast<char*>(data));
+#else
+    free(const_cast<char*>(data));
+#endif
+
+    data = nullptr;
+    size = 0;
+    mapped = false;
+}
@@ -103,3 +103,29 @@ Result Initializer::term(CanvasEngine engine) noexcept
 
     return Result::Success;
 }
+
+
+Result Initializer::cache(uint32_t bytes) noexcept
+{
+    LoaderMgr::budget(bytes);
+
+    return Result::Success;
+}
+
+
+Result Initializer::storage(const std::string& dir) noexcept
+{
+    if (LoaderMgr::storage(dir)) return Result::Success;
+#ifdef THORVG_TVG_LOADER_SUPPORT
+    return Result::InvalidArguments;
+#endif
+    return Result::NonSupport;
+}
+
+
+Result Initializer::purge() noexcept
+{
+    LoaderMgr::purge();
+
+    return Result::Success;
+}
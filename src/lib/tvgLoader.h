@@ -37,15 +37,31 @@ public:
     float vh = 0;
     float w = 0, h = 0;         //default image size
     bool preserveAspect = true; //keep aspect ratio by default.
+    bool streaming = false;     //too large to keep the whole pixels(), decode() the visible regions on demand.
+    bool feeding = false;       //the data arrives by feed(), not complete until read().
+    bool cached = false;        //shared by the pictures of the same resource through the LoaderMgr, read() is done.
+    uint64_t hash = 0;          //identity of the resource for the LoaderMgr cache, zero if not to be cached.
+    string key;                 //the resource the hash is made of, checked on a hit of the LoaderMgr cache.
+    uint32_t footprint = 0;     //estimated memory of the decoded resource in bytes.
+    string compiled;            //path to save the scene() in the binary format, empty if not to be compiled.
 
     virtual ~Loader() {}
 
     virtual bool open(const string& path) { /* Not supported */ return false; };
     virtual bool open(const char* data, uint32_t size, bool copy) { /* Not supported */ return false; };
-    virtual bool open(const uint32_t* data, uint32_t w, uint32_t h, bool copy) { /* Not supported */ return false; };
+    virtual bool open(const void* data, uint32_t w, uint32_t h, uint32_t stride, Picture::PixelFormat format, bool copy) { /* Not supported */ return false; };
+    virtual bool feed(const char* data, uint32_t size) { /* Not supported */ return false; };  //parse the next chunk of the data
     virtual bool read() = 0;
     virtual bool close() = 0;
+    virtual void wait() {};                                            //until the read() running in a task is done
     virtual const uint32_t* pixels() { return nullptr; };
+    virtual uint32_t stride() { return static_cast<uint32_t>(w); };  //pixels per row of the pixels()
+    virtual uint32_t sampling() { return 1; };                         //image pixels per a pixel of the pixels() in each direction
+    virtual void fit(float w, float h) {};                             //size of the image drawn, the pixels() may be decoded down to it before read()
+    virtual Picture::PixelFormat format() { return Picture::Color32; };  //memory layout of the pixels()
+    virtual bool arranged(uint32_t cs) { return true; };                 //whether the pixels() are in the order of the SwCanvas::Colorspace
+    virtual bool colorspace(uint32_t cs) { return false; };              //arrange the pixels() in place, only by the sole owner of the loader. true if changed
+    virtual uint32_t* decode(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t step, uint32_t cs) { return nullptr; };  //region of the streaming image sampled every step pixels in the colorspace, the caller frees it
     virtual unique_ptr<Scene> scene() { return nullptr; };
 };
 
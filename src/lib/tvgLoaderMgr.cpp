@@ -19,7 +19,15 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <mutex>
+#include "tvgArray.h"
 #include "tvgLoaderMgr.h"
+#include "tvgBinaryDesc.h"
+#include "tvgFileSource.h"
 
 #ifdef THORVG_SVG_LOADER_SUPPORT
     #include "tvgSvgLoader.h"
@@ -43,6 +51,107 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+struct CacheEntry
+{
+    shared_ptr<Loader> loader;
+    uint64_t hash;
+    string key;         //the resource itself, a hash collision never hands back the other one.
+};
+
+//The loaders read once and shared by the later loads, from the least recently used one.
+static Array<CacheEntry*> _cache;
+static uint32_t _budget = 0;
+static uint32_t _bytes = 0;
+static mutex _mutex;
+
+//The directory keeping the svg compiled into the binary format.
+static string _storage;
+
+
+static uint64_t _hash(const void* data, uint32_t size, uint64_t hash = 14695981039346656037ULL)
+{
+    //FNV-1a
+    auto p = static_cast<const unsigned char*>(data);
+    for (auto end = p + size; p < end; ++p) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+
+//Drop the least recently used loaders until the rest fits in the budget.
+static void _evict(uint32_t budget)
+{
+    uint32_t i = 0;
+    while (i < _cache.count && _bytes > budget) {
+        _bytes -= _cache.data[i]->loader->footprint;
+        delete(_cache.data[i]);
+        ++i;
+    }
+    if (i == 0) return;
+    memmove(_cache.data, _cache.data + i, sizeof(CacheEntry*) * (_cache.count - i));
+    _cache.count -= i;
+}
+
+
+static bool _caching()
+{
+    lock_guard<mutex> lock(_mutex);
+    return _budget > 0;
+}
+
+
+static shared_ptr<Loader> _lookup(uint64_t hash, const string& key)
+{
+    lock_guard<mutex> lock(_mutex);
+
+    for (uint32_t i = 0; i < _cache.count; ++i) {
+        auto entry = _cache.data[i];
+        if (entry->hash != hash || entry->key != key) continue;
+        //Most recently used at the end.
+        memmove(_cache.data + i, _cache.data + i + 1, sizeof(CacheEntry*) * (_cache.count - i - 1));
+        _cache.data[_cache.count - 1] = entry;
+        return entry->loader;
+    }
+    return nullptr;
+}
+
+
+//The decoded pixels in 32 bits, or the source size for the vector data which is parsed into a scene.
+static uint32_t _footprint(FileType type, Loader* loader, uint32_t size)
+{
+    if (type == FileType::Svg || type == FileType::Tvg) return size;
+    return static_cast<uint32_t>(loader->w) * static_cast<uint32_t>(loader->h) * sizeof(uint32_t);
+}
+
+
+static shared_ptr<Loader> _ready(Loader* loader, FileType type, uint64_t hash, string& key, uint32_t size)
+{
+    loader->hash = hash;
+    loader->footprint = _footprint(type, loader, size) + static_cast<uint32_t>(key.size());
+    loader->key = move(key);
+    return shared_ptr<Loader>(loader);
+}
+
+
+//The compiled file is named by the source contents and the version, a stale one is never picked up.
+static Loader* _compiled(const char* data, uint32_t size, string& path)
+{
+#ifdef THORVG_TVG_LOADER_SUPPORT
+    static const char version[] = THORVG_VERSION_STRING TVG_BIN_HEADER_VERSION;
+    char name[24];
+    snprintf(name, sizeof(name), "/%016llx.tvg", static_cast<unsigned long long>(_hash(data, size, _hash(version, sizeof(version) - 1))));
+    path = _storage + name;
+
+    auto loader = new TvgLoader;
+    if (loader->open(path)) return loader;
+    delete(loader);
+#endif
+    return nullptr;
+}
+
+
 static Loader* _find(FileType type)
 {
     switch(type) {
@@ -114,14 +223,52 @@ static Loader* _find(FileType type)
 }
 
 
-static Loader* _find(const string& path)
+static FileType _convert(const string& path)
 {
     auto ext = path.substr(path.find_last_of(".") + 1);
-    if (!ext.compare("svg")) return _find(FileType::Svg);
-    if (!ext.compare("png")) return _find(FileType::Png);
-    if (!ext.compare("tvg")) return _find(FileType::Tvg);
-    if (!ext.compare("jpg")) return _find(FileType::Jpg);
-    return nullptr;
+    if (!ext.compare("svg")) return FileType::Svg;
+    if (!ext.compare("png")) return FileType::Png;
+    if (!ext.compare("tvg")) return FileType::Tvg;
+    if (!ext.compare("jpg")) return FileType::Jpg;
+    return FileType::Unknown;
+}
+
+
+//The same file is told by its canonical path, modification time and size.
+static uint64_t _identify(const string& path, uint32_t* size, string& key)
+{
+#ifdef _WIN32
+    auto canonical = _fullpath(nullptr, path.c_str(), 0);
+#else
+    auto canonical = realpath(path.c_str(), nullptr);
+#endif
+    if (!canonical) return 0;
+
+    uint64_t hash = 0;
+    struct stat info;
+    if (stat(canonical, &info) == 0) {
+        int64_t stamp[2] = {static_cast<int64_t>(info.st_mtime), static_cast<int64_t>(info.st_size)};
+        key.assign(canonical);
+        key.append(reinterpret_cast<const char*>(stamp), sizeof(stamp));
+        hash = _hash(key.data(), key.size());
+        *size = static_cast<uint32_t>(info.st_size);
+    }
+    free(canonical);
+    return hash;
+}
+
+
+//Tell the format from the leading bytes, so that only the matching loader opens the data.
+static FileType _sniff(const char* data, uint32_t size)
+{
+    auto sig = reinterpret_cast<const unsigned char*>(data);
+
+    if (size >= TVG_BIN_HEADER_SIGNATURE_LENGTH && !memcmp(data, TVG_BIN_HEADER_SIGNATURE, TVG_BIN_HEADER_SIGNATURE_LENGTH)) return FileType::Tvg;
+    if (size >= 8 && !memcmp(data, "\x89PNG\r\n\x1a\n", 8)) return FileType::Png;
+    if (size >= 3 && sig[0] == 0xff && sig[1] == 0xd8 && sig[2] == 0xff) return FileType::Jpg;
+
+    //Otherwise, the svg text which may begin with a BOM, spaces or comments ahead of the <?xml or <svg.
+    return FileType::Svg;
 }
 
 
@@ -140,7 +287,7 @@ bool LoaderMgr::init()
 
 bool LoaderMgr::term()
 {
-    //TODO:
+    purge();
 
     return true;
 }
@@ -150,9 +297,30 @@ shared_ptr<Loader> LoaderMgr::loader(const string& path, bool* invalid)
 {
     *invalid = false;
 
-    if (auto loader = _find(path)) {
-        if (loader->open(path)) return shared_ptr<Loader>(loader);
-        else delete(loader);
+    auto type = _convert(path);
+    if (type == FileType::Unknown) return nullptr;
+
+    uint64_t hash = 0;
+    uint32_t size = 0;
+    string key;
+    if (_caching() && (hash = _identify(path, &size, key))) {
+        if (auto loader = _lookup(hash, key)) return loader;
+    }
+
+    //The svg compiled before skips the parsing.
+    string compiled;
+    if (type == FileType::Svg && !_storage.empty()) {
+        FileSource file;
+        if (file.open(path)) {
+            if (auto loader = _compiled(file.data, file.size, compiled)) return _ready(loader, type, hash, key, size);
+        }
+    }
+
+    if (auto loader = _find(type)) {
+        if (loader->open(path)) {
+            loader->compiled = compiled;
+            return _ready(loader, type, hash, key, size);
+        } else delete(loader);
         *invalid = true;
     }
     return nullptr;
@@ -161,25 +329,101 @@ shared_ptr<Loader> LoaderMgr::loader(const string& path, bool* invalid)
 
 shared_ptr<Loader> LoaderMgr::loader(const char* data, uint32_t size, bool copy)
 {
-    for (int i = 0; i < static_cast<int>(FileType::Unknown); i++) {
-        auto loader = _find(static_cast<FileType>(i));
-        if (loader) {
-            if (loader->open(data, size, copy)) return shared_ptr<Loader>(loader);
-            else delete(loader);
-        }
+    //The same data is told by its contents.
+    uint64_t hash = 0;
+    string key;
+    if (_caching()) {
+        key.assign(data, size);
+        hash = _hash(&size, sizeof(size), _hash(data, size));
+        if (auto loader = _lookup(hash, key)) return loader;
+    }
+
+    auto type = _sniff(data, size);
+
+    //The svg compiled before skips the parsing.
+    string compiled;
+    if (type == FileType::Svg && !_storage.empty()) {
+        if (auto loader = _compiled(data, size, compiled)) return _ready(loader, type, hash, key, size);
+    }
+
+    if (auto loader = _find(type)) {
+        if (loader->open(data, size, copy)) {
+            loader->compiled = compiled;
+            return _ready(loader, type, hash, key, size);
+        } else delete(loader);
     }
     return nullptr;
 }
 
 
-shared_ptr<Loader> LoaderMgr::loader(const uint32_t *data, uint32_t w, uint32_t h, bool copy)
+shared_ptr<Loader> LoaderMgr::loader(const void* data, uint32_t w, uint32_t h, uint32_t stride, Picture::PixelFormat format, bool copy)
 {
-    for (int i = 0; i < static_cast<int>(FileType::Unknown); i++) {
-        auto loader = _find(static_cast<FileType>(i));
-        if (loader) {
-            if (loader->open(data, w, h, copy)) return shared_ptr<Loader>(loader);
-            else delete(loader);
-        }
+    //Only the raw loader takes the pixels.
+    if (auto loader = _find(FileType::Raw)) {
+        if (loader->open(data, w, h, stride, format, copy)) return shared_ptr<Loader>(loader);
+        else delete(loader);
     }
     return nullptr;
 }
+
+
+shared_ptr<Loader> LoaderMgr::feeder()
+{
+    //Only the svg can be parsed in chunks.
+    if (auto loader = _find(FileType::Svg)) return shared_ptr<Loader>(loader);
+    return nullptr;
+}
+
+
+void LoaderMgr::cache(shared_ptr<Loader> loader)
+{
+    //The regions of the streaming image and the reduced decoding belong to each picture.
+    if (loader->hash == 0 || loader->cached || loader->streaming || loader->sampling() > 1) return;
+
+    lock_guard<mutex> lock(_mutex);
+
+    if (_budget == 0 || loader->footprint > _budget) return;
+
+    auto entry = new CacheEntry;
+    entry->loader = loader;
+    entry->hash = loader->hash;
+    entry->key = move(loader->key);
+    loader->cached = true;
+    _cache.push(entry);
+    _bytes += loader->footprint;
+
+    _evict(_budget);
+}
+
+
+void LoaderMgr::budget(uint32_t bytes)
+{
+    lock_guard<mutex> lock(_mutex);
+
+    _budget = bytes;
+    _evict(_budget);
+}
+
+
+void LoaderMgr::purge()
+{
+    lock_guard<mutex> lock(_mutex);
+
+    for (uint32_t i = 0; i < _cache.count; ++i) delete(_cache.data[i]);
+    _cache.reset();
+    _bytes = 0;
+}
+
+
+bool LoaderMgr::storage(const string& dir)
+{
+#ifdef THORVG_TVG_LOADER_SUPPORT
+    if (!dir.empty()) {
+        struct stat info;
+        if (stat(dir.c_str(), &info) != 0 || !(info.st_mode & S_IFDIR)) return false;
+    }
+    _storage = dir;
+    return true;
+#endif
+    return false;
+}
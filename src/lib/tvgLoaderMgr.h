@@ -32,7 +32,12 @@ struct LoaderMgr
     static bool term();
     static shared_ptr<Loader> loader(const string& path, bool* invalid);
     static shared_ptr<Loader> loader(const char* data, uint32_t size, bool copy);
-    static shared_ptr<Loader> loader(const uint32_t* data, uint32_t w, uint32_t h, bool copy);
+    static shared_ptr<Loader> loader(const void* data, uint32_t w, uint32_t h, uint32_t stride, Picture::PixelFormat format, bool copy);
+    static shared_ptr<Loader> feeder();
+    static void cache(shared_ptr<Loader> loader);
+    static void budget(uint32_t bytes);
+    static void purge();
+    static bool storage(const string& dir);
 };
 
 #endif //_TVG_LOADER_MGR_H_
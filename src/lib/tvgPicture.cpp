@@ -20,7 +20,137 @@
  * SOFTWARE.
  */
 
+#include <string.h>
 #include "tvgPictureImpl.h"
+#include "tvgSaverImpl.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+//Keep the scene built from the source for the next loads, in the binary format with the view box.
+void Picture::Impl::compile()
+{
+    //A partial file is never seen by the other loads, it's renamed when complete.
+    auto saver = Saver::gen();
+    P(saver.get())->save(paint, loader->compiled, loader.get());
+    loader->compiled.clear();
+}
+
+
+//The pixels in their own format, of the loader if they are not taken yet.
+const void* Picture::Impl::data(uint32_t* w, uint32_t* h, uint32_t* stride, Picture::PixelFormat* format) const
+{
+    RenderImage out = image;
+    if (!pixels) {
+        if (loader) share();
+        if (!source(out)) return nullptr;
+    }
+    if (w) *w = out.w;
+    if (h) *h = out.h;
+    if (stride) *stride = out.stride;
+    if (format) *format = static_cast<Picture::PixelFormat>(out.format);
+    return out.buffer;
+}
+
+
+//The compact pixels are expanded into the picture's copy, kept until the next call.
+const uint32_t* Picture::Impl::data()
+{
+    //Try it, If not loaded yet.
+    if (loader && loader->format() == Picture::Color32) {
+        share();
+        return loader->pixels();
+    }
+
+    uint32_t w, h, stride;
+    Picture::PixelFormat format;
+    auto buffer = data(&w, &h, &stride, &format);
+    if (!buffer || format == Picture::Color32) return static_cast<const uint32_t*>(buffer);
+
+    RenderImage src = image;
+    src.buffer = const_cast<uint32_t*>(static_cast<const uint32_t*>(buffer));
+    src.w = w;
+    src.h = h;
+    src.stride = stride;
+    src.format = format;
+
+    auto copy = static_cast<uint32_t*>(realloc(expanded, sizeof(uint32_t) * w * h));
+    if (!copy) return nullptr;
+    expanded = copy;
+    for (uint32_t y = 0; y < h; ++y) {
+        expandRow(src, y, expanded + y * w);
+    }
+    return expanded;
+}
+
+
+//A row of the compact pixels in the 32-bit ones.
+void Picture::Impl::expandRow(const RenderImage& image, uint32_t y, uint32_t* row)
+{
+    for (uint32_t x = 0; x < image.w; ++x) {
+        auto offset = y * image.stride + x;
+        switch (image.format) {
+            case Picture::A8: {
+                uint32_t a = image.buffer8[offset];
+                //Rounded the same as the raster engine blends the tint color.
+                row[x] = (a << 24) | (((image.tint[0] * a + 0xff) >> 8) << 16) | (((image.tint[1] * a + 0xff) >> 8) << 8) | ((image.tint[2] * a + 0xff) >> 8);
+                break;
+            }
+            case Picture::L8: {
+                uint32_t l = image.buffer8[offset];
+                row[x] = 0xff000000 | (l << 16) | (l << 8) | l;
+                break;
+            }
+            default: {
+                auto c = image.buffer16[offset];
+                uint32_t r = (c >> 11) & 0x1f;
+                uint32_t g = (c >> 5) & 0x3f;
+                uint32_t b = c & 0x1f;
+                row[x] = 0xff000000 | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+                break;
+            }
+        }
+    }
+}
+
+
+//Swap the red and the blue channels for the other colorspace.
+static void _swapChannels(uint32_t* buffer, uint32_t len)
+{
+    for (auto dst = buffer; dst < buffer + len; ++dst) {
+        auto c = *dst;
+        *dst = (c & 0xff00ff00) | ((c & 0x00ff0000) >> 16) | ((c & 0x000000ff) << 16);
+    }
+}
+
+
+/* Arrange the pixels in the target colorspace, true if changed.
+   The pixels shared with the other pictures are never touched, but copied. */
+bool Picture::Impl::arrange(uint32_t cs)
+{
+    if (!pixels || image.format != Picture::Color32) return false;
+
+    if (!owned) {
+        if (!loader || loader->arranged(cs)) return false;
+        if (loader.use_count() == 1) return loader->colorspace(cs);
+
+        auto copy = static_cast<uint32_t*>(malloc(sizeof(uint32_t) * image.w * image.h));
+        if (!copy) return false;
+        for (uint32_t y = 0; y < image.h; ++y) {
+            memcpy(copy + y * image.w, pixels + y * image.stride, sizeof(uint32_t) * image.w);
+        }
+        pixels = copy;
+        image.buffer = pixels;
+        image.stride = image.w;
+        owned = true;
+    } else if (this->cs == cs) return false;
+
+    _swapChannels(pixels, image.stride * image.h);
+    this->cs = cs;
+    return true;
+}
+
 
 /************************************************************************/
 /* External Class Implementation                                        */
@@ -61,11 +191,52 @@ Result Picture::load(const char* data, uint32_t size, bool copy) noexcept
 }
 
 
+Result Picture::feed(const char* data, uint32_t size) noexcept
+{
+    if (!data || size <= 0) return Result::InvalidArguments;
+
+    return pImpl->feed(data, size);
+}
+
+
+Result Picture::finish() noexcept
+{
+    return pImpl->finish();
+}
+
+
 Result Picture::load(uint32_t* data, uint32_t w, uint32_t h, bool copy) noexcept
 {
     if (!data || w <= 0 || h <= 0) return Result::InvalidArguments;
 
-    return pImpl->load(data, w, h, copy);
+    return pImpl->load(data, w, h, w, Picture::Color32, copy);
+}
+
+
+Result Picture::load(uint32_t* data, uint32_t stride, uint32_t x, uint32_t y, uint32_t w, uint32_t h, bool copy) noexcept
+{
+    if (!data || w <= 0 || h <= 0 || x > stride || w > stride - x) return Result::InvalidArguments;
+
+    return pImpl->load(data + y * stride + x, w, h, stride, Picture::Color32, copy);
+}
+
+
+Result Picture::load(const void* data, PixelFormat format, uint32_t w, uint32_t h, uint32_t stride, bool copy) noexcept
+{
+    if (!data || w <= 0 || h <= 0 || stride < w) return Result::InvalidArguments;
+
+    return pImpl->load(data, w, h, stride, format, copy);
+}
+
+
+Result Picture::tint(uint8_t r, uint8_t g, uint8_t b) noexcept
+{
+    pImpl->image.tint[0] = r;
+    pImpl->image.tint[1] = g;
+    pImpl->image.tint[2] = b;
+    Paint::pImpl->flag |= RenderUpdateFlag::Color;
+
+    return Result::Success;
 }
 
 
@@ -94,10 +265,13 @@ Result Picture::size(float* w, float* h) const noexcept
 
 const uint32_t* Picture::data() const noexcept
 {
-    //Try it, If not loaded yet.
-    if (pImpl->loader) return pImpl->loader->pixels();
+    return pImpl->data();
+}
 
-    return pImpl->pixels;
+
+const void* Picture::data(uint32_t* w, uint32_t* h, uint32_t* stride, PixelFormat* format) const noexcept
+{
+    return pImpl->data(w, h, stride, format);
 }
 
 
@@ -23,6 +23,8 @@
 #define _TVG_PICTURE_IMPL_H_
 
 #include <string>
+#include <float.h>
+#include <math.h>
 #include "tvgPaint.h"
 #include "tvgLoaderMgr.h"
 
@@ -35,10 +37,17 @@ struct Picture::Impl
     shared_ptr<Loader> loader = nullptr;
     Paint* paint = nullptr;
     uint32_t *pixels = nullptr;
+    RenderImage image = {};             //pixels information for the engine
+    RenderRegion region = {};           //decoded region of the streaming image
+    uint32_t step = 0;                  //sampling step of the region
+    uint32_t cs = 0;                    //SwCanvas::Colorspace of the own pixels
+    bool owned = false;                 //pixels are the picture's own, not shared with the loader
+    uint32_t* expanded = nullptr;       //32-bit copy of the compact pixels for the data()
     Picture *picture = nullptr;
     void *rdata = nullptr;              //engine data
     float w = 0, h = 0;
     bool resizing = false;
+    bool resized = false;               //size changed since the last update
 
     Impl(Picture* p) : picture(p)
     {
@@ -47,6 +56,9 @@ struct Picture::Impl
     ~Impl()
     {
         if (paint) delete(paint);
+        //The decoded region and the arranged copy are not shared with the loader.
+        if (owned) free(pixels);
+        free(expanded);
     }
 
     bool dispose(RenderMethod& renderer)
@@ -93,32 +105,189 @@ struct Picture::Impl
         resizing = false;
     }
 
+    void compile();
+    bool arrange(uint32_t cs);
+    const void* data(uint32_t* w, uint32_t* h, uint32_t* stride, Picture::PixelFormat* format) const;
+    const uint32_t* data();
+    static void expandRow(const RenderImage& image, uint32_t y, uint32_t* row);
+
+    //Describes the pixels of the loader into the image, without taking them over.
+    bool source(RenderImage& out) const
+    {
+        if (!loader || loader->feeding || loader->streaming) return false;
+        auto data = const_cast<uint32_t*>(loader->pixels());
+        if (!data) return false;
+
+        auto sampling = loader->sampling();
+        out = image;
+        out.buffer = data;
+        out.stride = loader->stride();
+        out.w = (static_cast<uint32_t>(loader->w) + sampling - 1) / sampling;
+        out.h = (static_cast<uint32_t>(loader->h) + sampling - 1) / sampling;
+        out.format = loader->format();
+        return true;
+    }
+
     uint32_t reload()
     {
-        if (loader) {
+        if (loader && !loader->feeding) {
             if (!paint) {
+                share();
                 auto scene = loader->scene();
                 if (scene) {
                     paint = scene.release();
-                    loader->close();
+                    if (!loader->compiled.empty()) compile();
+                    if (!loader->cached) loader->close();
                     if (w != loader->w && h != loader->h) resize();
                     if (paint) return RenderUpdateFlag::None;
                 }
             }
-            if (!pixels) {
-                pixels = const_cast<uint32_t*>(loader->pixels());
-                loader->close();
+            if (!pixels && !loader->streaming) {
+                share();
+                if (source(image)) pixels = image.buffer;
+                if (!loader->cached) loader->close();
                 if (pixels) return RenderUpdateFlag::Image;
             }
         }
         return RenderUpdateFlag::None;
     }
 
+    //The other pictures get the loader from the cache only once it is decoded, the cached one is never closed.
+    void share() const
+    {
+        //Once taken by this picture, the resource may be moved out or closed.
+        if (loader->cached || paint || pixels) return;
+        loader->wait();
+        LoaderMgr::cache(loader);
+    }
+
+    /* Scale the reduced decoding back up, the raster image is drawn in its own size.
+       Returns false if the pixels are drawn as they are. */
+    bool fit(RenderTransform& fitting)
+    {
+        auto sampling = static_cast<float>(loader->sampling());
+        if (sampling == 1.0f) return false;
+
+        fitting.m = {sampling, 0, 0, 0, sampling, 0, 0, 0, 1};
+        return true;
+    }
+
+    /* Find out the part of the image in the viewport and the sampling step,
+       the region is mapped back with the inverse of the transform. */
+    bool visible(RenderMethod& renderer, const RenderTransform* transform, RenderRegion& region, uint32_t& step)
+    {
+        Matrix m = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+        if (transform) m = transform->m;
+
+        auto det = m.e11 * m.e22 - m.e12 * m.e21;
+        if (fabsf(det) < FLT_EPSILON) return false;
+
+        //Sample every power of two pixels of the downscaled image, not to decode the unseen details.
+        step = 1;
+        while (step * 2 * sqrtf(fabsf(det)) <= 1.0f) step *= 2;
+
+        auto vport = renderer.viewport();
+        float corners[4][2] = {{float(vport.x), float(vport.y)}, {float(vport.x + vport.w), float(vport.y)},
+                               {float(vport.x), float(vport.y + vport.h)}, {float(vport.x + vport.w), float(vport.y + vport.h)}};
+        auto minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+        for (int i = 0; i < 4; ++i) {
+            auto dx = corners[i][0] - m.e13;
+            auto dy = corners[i][1] - m.e23;
+            auto x = (m.e22 * dx - m.e12 * dy) / det;
+            auto y = (m.e11 * dy - m.e21 * dx) / det;
+            if (x < minX) minX = x;
+            if (x > maxX) maxX = x;
+            if (y < minY) minY = y;
+            if (y > maxY) maxY = y;
+        }
+
+        auto x1 = static_cast<int32_t>(floorf(minX)) - static_cast<int32_t>(step);
+        auto y1 = static_cast<int32_t>(floorf(minY)) - static_cast<int32_t>(step);
+        auto x2 = static_cast<int32_t>(ceilf(maxX)) + static_cast<int32_t>(step);
+        auto y2 = static_cast<int32_t>(ceilf(maxY)) + static_cast<int32_t>(step);
+        if (x1 < 0) x1 = 0;
+        if (y1 < 0) y1 = 0;
+        if (x2 > static_cast<int32_t>(loader->w)) x2 = static_cast<int32_t>(loader->w);
+        if (y2 > static_cast<int32_t>(loader->h)) y2 = static_cast<int32_t>(loader->h);
+        if (x2 <= x1 || y2 <= y1) return false;
+
+        region = {static_cast<uint32_t>(x1), static_cast<uint32_t>(y1), static_cast<uint32_t>(x2 - x1), static_cast<uint32_t>(y2 - y1)};
+        return true;
+    }
+
+    void* stream(RenderMethod &renderer, const RenderTransform* transform, uint32_t opacity, Array<RenderData>& clips, uint32_t flag)
+    {
+        RenderRegion visibleRegion;
+        uint32_t visibleStep;
+
+        if (visible(renderer, transform, visibleRegion, visibleStep)) {
+            //Decode again, only when the visible part gets out of the decoded region.
+            if (visibleStep != step || cs != renderer.colorSpace() || visibleRegion.x < region.x || visibleRegion.y < region.y ||
+                visibleRegion.x + visibleRegion.w > region.x + region.w || visibleRegion.y + visibleRegion.h > region.y + region.h) {
+                //Margin for the next scrolls, and aligned to the sampling grid.
+                auto marginX = visibleRegion.w / 4;
+                auto marginY = visibleRegion.h / 4;
+                auto x1 = (visibleRegion.x > marginX ? visibleRegion.x - marginX : 0) / visibleStep * visibleStep;
+                auto y1 = (visibleRegion.y > marginY ? visibleRegion.y - marginY : 0) / visibleStep * visibleStep;
+                auto x2 = visibleRegion.x + visibleRegion.w + marginX;
+                auto y2 = visibleRegion.y + visibleRegion.h + marginY;
+                if (x2 > static_cast<uint32_t>(loader->w)) x2 = static_cast<uint32_t>(loader->w);
+                if (y2 > static_cast<uint32_t>(loader->h)) y2 = static_cast<uint32_t>(loader->h);
+
+                auto buffer = loader->decode(x1, y1, x2 - x1, y2 - y1, visibleStep, renderer.colorSpace());
+                if (buffer) {
+                    free(pixels);
+                    pixels = buffer;
+                    owned = true;
+                    cs = renderer.colorSpace();
+                    region = {x1, y1, x2 - x1, y2 - y1};
+                    step = visibleStep;
+                    image.buffer = pixels;
+                    image.w = (region.w + step - 1) / step;
+                    image.h = (region.h + step - 1) / step;
+                    image.stride = image.w;
+                    image.format = Picture::Color32;
+                    flag |= RenderUpdateFlag::Image;
+                }
+            }
+        }
+
+        if (!pixels) return rdata;
+
+        //Place the sampled region onto the image space.
+        RenderTransform sampling;
+        sampling.m = {float(step), 0, float(region.x), 0, float(step), float(region.y), 0, 0, 1};
+        if (!transform) return renderer.prepare(&image, rdata, &sampling, opacity, clips, static_cast<RenderUpdateFlag>(flag));
+        RenderTransform outTransform(transform, &sampling);
+        return renderer.prepare(&image, rdata, &outTransform, opacity, clips, static_cast<RenderUpdateFlag>(flag));
+    }
+
     void* update(RenderMethod &renderer, const RenderTransform* transform, uint32_t opacity, Array<RenderData>& clips, RenderUpdateFlag pFlag)
     {
         auto flag = reload();
+        if (resized) {
+            flag |= RenderUpdateFlag::Transform;
+            resized = false;
+        }
 
-        if (pixels) rdata = renderer.prepare(*picture, rdata, transform, opacity, clips, static_cast<RenderUpdateFlag>(pFlag | flag));
+        RenderTransform fitting, outTransform;
+        if (!paint && loader && loader->w > 0 && loader->h > 0 && fit(fitting)) {
+            if (transform) {
+                outTransform = RenderTransform(transform, &fitting);
+                transform = &outTransform;
+            } else transform = &fitting;
+        }
+
+        //Too large image, only the visible part is decoded.
+        if (loader && loader->streaming && !paint) {
+            rdata = stream(renderer, transform, opacity, clips, pFlag | flag);
+            return rdata;
+        }
+
+        //Decoded pixels are arranged once for the target, not at the every raster time.
+        if (arrange(renderer.colorSpace())) flag |= RenderUpdateFlag::Image;
+
+        if (pixels) rdata = renderer.prepare(&image, rdata, transform, opacity, clips, static_cast<RenderUpdateFlag>(pFlag | flag));
         else if (paint) {
             if (resizing) resize();
             rdata = paint->pImpl->update(renderer, transform, opacity, clips, static_cast<RenderUpdateFlag>(pFlag | flag));
@@ -130,6 +299,8 @@ struct Picture::Impl
     {
         if (pixels) return renderer.renderImage(rdata);
         else if (paint) return paint->pImpl->render(renderer);
+        //Streaming image out of the viewport.
+        else if (loader && loader->streaming) return true;
         return false;
     }
 
@@ -148,6 +319,7 @@ struct Picture::Impl
         this->w = w;
         this->h = h;
         resizing = true;
+        resized = true;
         return true;
     }
 
@@ -166,34 +338,72 @@ struct Picture::Impl
 
     Result load(const string& path)
     {
-        if (loader) loader->close();
+        if (loader && !loader->cached) loader->close();
         bool invalid;  //Invalid Path
         loader = LoaderMgr::loader(path, &invalid);
         if (!loader) {
             if (invalid) return Result::InvalidArguments;
             return Result::NonSupport;
         }
-        if (!loader->read()) return Result::Unknown;
-        w = loader->w;
-        h = loader->h;
+        //The size requested in advance is kept, the decoding may go down to it.
+        if (!loader->cached) {
+            if (resizing) loader->fit(w, h);
+            if (!loader->read()) return Result::Unknown;
+        }
+        if (!resizing) {
+            w = loader->w;
+            h = loader->h;
+        }
         return Result::Success;
     }
 
     Result load(const char* data, uint32_t size, bool copy)
     {
-        if (loader) loader->close();
+        if (loader && !loader->cached) loader->close();
         loader = LoaderMgr::loader(data, size, copy);
         if (!loader) return Result::NonSupport;
+        //The size requested in advance is kept, the decoding may go down to it.
+        if (!loader->cached) {
+            if (resizing) loader->fit(w, h);
+            if (!loader->read()) return Result::Unknown;
+        }
+        if (!resizing) {
+            w = loader->w;
+            h = loader->h;
+        }
+        return Result::Success;
+    }
+
+    Result feed(const char* data, uint32_t size)
+    {
+        if (!loader || !loader->feeding) {
+            if (loader && !loader->cached) loader->close();
+            loader = LoaderMgr::feeder();
+            if (!loader) return Result::NonSupport;
+        }
+        if (!loader->feed(data, size)) return Result::Unknown;
+        if (!resizing) {
+            w = loader->w;
+            h = loader->h;
+        }
+        return Result::Success;
+    }
+
+    Result finish()
+    {
+        if (!loader || !loader->feeding) return Result::InsufficientCondition;
         if (!loader->read()) return Result::Unknown;
-        w = loader->w;
-        h = loader->h;
+        if (!resizing) {
+            w = loader->w;
+            h = loader->h;
+        }
         return Result::Success;
     }
 
-    Result load(uint32_t* data, uint32_t w, uint32_t h, bool copy)
+    Result load(const void* data, uint32_t w, uint32_t h, uint32_t stride, Picture::PixelFormat format, bool copy)
     {
-        if (loader) loader->close();
-        loader = LoaderMgr::loader(data, w, h, copy);
+        if (loader && !loader->cached) loader->close();
+        loader = LoaderMgr::loader(data, w, h, stride, format, copy);
         if (!loader) return Result::NonSupport;
         this->w = loader->w;
         this->h = loader->h;
@@ -211,7 +421,11 @@ struct Picture::Impl
         if (paint) dup->paint = paint->duplicate();
 
         dup->loader = loader;
-        dup->pixels = pixels;
+        //Streaming image decodes its own region, and the arranged copy is made again by the target.
+        if (!owned) {
+            dup->pixels = pixels;
+            dup->image = image;
+        } else if (source(dup->image)) dup->pixels = dup->image.buffer;
         dup->w = w;
         dup->h = h;
         dup->resizing = resizing;
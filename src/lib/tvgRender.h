@@ -39,6 +39,20 @@ struct Surface
     uint32_t  cs;
 };
 
+//Pixels of a picture for the engine
+struct RenderImage
+{
+    union {
+        uint32_t* buffer;                 //Picture::Color32
+        uint16_t* buffer16;               //Picture::RGB565
+        uint8_t*  buffer8;                //Picture::A8, Picture::L8
+    };
+    uint32_t  stride;                     //pixels per row of the buffer
+    uint32_t  w, h;
+    uint32_t  format;                     //Picture::PixelFormat
+    uint8_t   tint[3];                    //rgb color of the Picture::A8 pixels
+};
+
 using RenderData = void*;
 
 struct Compositor {
@@ -84,7 +98,7 @@ class RenderMethod
 public:
     virtual ~RenderMethod() {}
     virtual RenderData prepare(const Shape& shape, RenderData data, const RenderTransform* transform, uint32_t opacity, Array<RenderData>& clips, RenderUpdateFlag flags) = 0;
-    virtual RenderData prepare(const Picture& picture, RenderData data, const RenderTransform* transform, uint32_t opacity, Array<RenderData>& clips, RenderUpdateFlag flags) = 0;
+    virtual RenderData prepare(RenderImage* image, RenderData data, const RenderTransform* transform, uint32_t opacity, Array<RenderData>& clips, RenderUpdateFlag flags) = 0;
     virtual bool preRender() = 0;
     virtual bool renderShape(RenderData data) = 0;
     virtual bool renderImage(RenderData data) = 0;
@@ -93,6 +107,7 @@ public:
     virtual RenderRegion region(RenderData data) = 0;
     virtual RenderRegion viewport() = 0;
     virtual bool viewport(const RenderRegion& vp) = 0;
+    virtual uint32_t colorSpace() = 0;
 
     virtual bool clear() = 0;
     virtual bool sync() = 0;
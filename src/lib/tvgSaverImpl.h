@@ -23,10 +23,30 @@
 #define _TVG_SAVER_IMPL_H_
 
 #include "tvgPaint.h"
+#include "tvgPictureImpl.h"
 #include "tvgBinaryDesc.h"
+#include "tvgArray.h"
+#include "tvgCompressor.h"
 #include <float.h>
 #include <math.h>
+#include <stdio.h>
 #include <fstream>
+#include <atomic>
+#ifdef _WIN32
+    #include <process.h>
+    #define getpid _getpid
+#else
+    #include <unistd.h>
+#endif
+
+//The scenes with this many children keep the index of them.
+#define TVG_SCENE_INDEX_MIN_COUNT 8
+
+//The paints of this many bytes are compressed, unless a part of them is tried already.
+#define TVG_COMPRESS_MIN_SIZE (4 * 1024)
+
+//The paints done below the first scene go out to the file once the buffer holds this many bytes.
+#define TVG_FLUSH_SIZE (256 * 1024)
 
 struct Saver::Impl
 {
@@ -35,6 +55,11 @@ struct Saver::Impl
     char* pointer = nullptr;
     uint32_t size = 0;
     uint32_t reserved = 0;
+    uint32_t flushed = 0;           //bytes written to the file ahead of the buffer
+    uint32_t compressCnt = 0;       //paints tried to compress
+    uint32_t depth = 0;             //paints being serialized, the root is the first
+    uint32_t sceneDepth = 0;        //depth of the first scene, zero until it's met
+    ofstream file;
 
 
     Impl(Saver* s) : saver(s)
@@ -61,18 +86,15 @@ struct Saver::Impl
     }
 
 
+    //Twice as large at least, not to copy the buffer over again as it grows.
     void resizeBuffer(uint32_t newSize)
     {
-        //OPTIMIZE ME: find more optimal alg ? "*2" is not opt when raw/png is used
-        reserved += 100;
-        if (newSize > reserved) reserved = newSize + 100;
-
-        auto bufferOld = buffer;
+        reserved *= 2;
+        if (newSize > reserved) reserved = newSize;
 
+        auto offset = pointer - buffer;
         buffer = static_cast<char*>(realloc(buffer, reserved));
-
-        if (buffer != bufferOld)
-            pointer = buffer + (pointer - bufferOld);
+        pointer = buffer + offset;
     }
 
 
@@ -92,28 +114,44 @@ struct Saver::Impl
         pointer = nullptr;
         size = 0;
         reserved = 0;
+        flushed = 0;
+        compressCnt = 0;
+        depth = 0;
+        sceneDepth = 0;
     }
 
 
-    bool saveBufferToFile(const std::string& path)
+    //Writes the buffer out to the file, the data in it won't change but the byte counters.
+    bool flushBuffer()
     {
-        ofstream outFile;
-        outFile.open(path, ios::out | ios::trunc | ios::binary);
-        if (!outFile.is_open()) return false;
-        outFile.write(buffer, size);
-        outFile.close();
+        file.write(buffer, size);
+        flushed += size;
+        pointer = buffer;
+        size = 0;
+        return file.good();
+    }
 
-        return true;
+
+    //Patches the data at the position from the start, in the buffer or in the file.
+    void writeAt(uint32_t pos, const void* data, uint32_t byteCnt)
+    {
+        if (pos >= flushed) {
+            memcpy(buffer + (pos - flushed), data, byteCnt);
+            return;
+        }
+        file.seekp(pos);
+        file.write(static_cast<const char*>(data), byteCnt);
+        file.seekp(0, ios::end);
     }
 
 
-    bool writeHeader()
+    bool writeHeader(const Loader* source)
     {
         const char *tvg = TVG_BIN_HEADER_SIGNATURE;
         const char *version = TVG_BIN_HEADER_VERSION;
-        //TODO  - unused header data
-        uint16_t dataByteCnt = 0;
-        ByteCounter headerByteCnt = TVG_BIN_HEADER_SIGNATURE_LENGTH + TVG_BIN_HEADER_VERSION_LENGTH + TVG_BIN_HEADER_DATA_LENGTH;
+        //The view box of the source, if any.
+        uint16_t dataByteCnt = source ? TVG_BIN_HEADER_META_VIEWBOX_LENGTH : 0;
+        ByteCounter headerByteCnt = TVG_BIN_HEADER_SIGNATURE_LENGTH + TVG_BIN_HEADER_VERSION_LENGTH + TVG_BIN_HEADER_DATA_LENGTH + dataByteCnt;
         if (size + headerByteCnt > reserved) resizeBuffer(headerByteCnt);
 
         memcpy(pointer, tvg, TVG_BIN_HEADER_SIGNATURE_LENGTH);
@@ -123,6 +161,13 @@ struct Saver::Impl
         memcpy(pointer, &dataByteCnt, TVG_BIN_HEADER_DATA_LENGTH);
         pointer += TVG_BIN_HEADER_DATA_LENGTH;
 
+        if (source) {
+            float viewbox[6] = {source->vx, source->vy, source->vw, source->vh, source->w, source->h};
+            memcpy(pointer, viewbox, sizeof(viewbox));
+            pointer += sizeof(viewbox);
+            *pointer++ = source->preserveAspect ? 1 : 0;
+        }
+
         size += headerByteCnt;
         return true;
     }
@@ -150,7 +195,7 @@ struct Saver::Impl
 
     void writeMemberDataSizeAt(ByteCounter byteCnt)
     {
-        memcpy(pointer - byteCnt - BYTE_COUNTER_SIZE, &byteCnt, BYTE_COUNTER_SIZE);
+        writeAt(flushed + size - byteCnt - BYTE_COUNTER_SIZE, &byteCnt, BYTE_COUNTER_SIZE);
     }
 
 
@@ -193,6 +238,33 @@ struct Saver::Impl
     }
 
 
+    /* Replaces the paint block just written with the compressed one, if it's smaller.
+       The data is compressed past the end of the buffer, and moved back in place of the paint. */
+    ByteCounter compressBlock(ByteCounter blockByteCnt)
+    {
+        ByteCounter headerByteCnt = TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE;
+        ByteCounter dataByteCnt = blockByteCnt - headerByteCnt;
+        auto capacity = lz4Bound(dataByteCnt);
+        if (size + capacity > reserved) resizeBuffer(size + capacity);
+
+        auto compressedByteCnt = lz4Compress(pointer - dataByteCnt, dataByteCnt, pointer, capacity);
+        if (compressedByteCnt == 0 || headerByteCnt + compressedByteCnt >= dataByteCnt) return blockByteCnt;
+
+        //The header of the paint goes ahead of its compressed data.
+        auto block = pointer - blockByteCnt;
+        memmove(block + headerByteCnt, block, headerByteCnt);
+        memcpy(block + 2 * headerByteCnt, pointer, compressedByteCnt);
+
+        auto ind = TVG_COMPRESSED_BLOCK_INDICATOR;
+        ByteCounter compressedBlockByteCnt = headerByteCnt + compressedByteCnt;
+        memcpy(block, &ind, TVG_INDICATOR_SIZE);
+        memcpy(block + TVG_INDICATOR_SIZE, &compressedBlockByteCnt, BYTE_COUNTER_SIZE);
+
+        rewindBuffer(blockByteCnt - headerByteCnt - compressedBlockByteCnt);
+        return headerByteCnt + compressedBlockByteCnt;
+    }
+
+
     ByteCounter serializePaint(const Paint* paint)
     {
         ByteCounter paintDataByteCnt = 0;
@@ -229,7 +301,33 @@ struct Saver::Impl
         writeMemberIndicator(TVG_SCENE_BEGIN_INDICATOR);
         skipInBufferMemberDataSize();
 
-        sceneDataByteCnt += serializeChildren(paint);
+        Array<const Paint*> children;
+        for (auto it = paint->begin(); it != paint->end(); ++it) {
+            children.push(&(*it));
+        }
+
+        //The offsets of the children go ahead of them, filled in as they are written.
+        uint32_t index = 0;
+        auto begin = flushed + size;
+        if (children.count >= TVG_SCENE_INDEX_MIN_COUNT) {
+            ByteCounter indexByteCnt = children.count * sizeof(uint32_t);
+            writeMemberIndicator(TVG_SCENE_INDEX_INDICATOR);
+            writeMemberDataSize(indexByteCnt);
+            if (size + indexByteCnt > reserved) resizeBuffer(size + indexByteCnt);
+            index = flushed + size;
+            pointer += indexByteCnt;
+            size += indexByteCnt;
+            sceneDataByteCnt += TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE + indexByteCnt;
+        }
+
+        for (uint32_t i = 0; i < children.count; ++i) {
+            if (index > 0) {
+                uint32_t offset = flushed + size - begin;
+                writeAt(index + i * sizeof(uint32_t), &offset, sizeof(offset));
+            }
+            sceneDataByteCnt += serialize(children.data[i]);
+        }
+
         sceneDataByteCnt += serializePaint(scene);
 
         writeMemberDataSizeAt(sceneDataByteCnt);
@@ -322,6 +420,73 @@ struct Saver::Impl
     }
 
 
+    //The smallest decimal precision the coordinates come back exactly from, -1 if none.
+    int32_t pathPrecision(const Point* pts, uint32_t ptsCnt)
+    {
+        auto coords = reinterpret_cast<const float*>(pts);
+        for (uint8_t precision = 0; precision <= TVG_SHAPE_PATH_PRECISION_MAX; ++precision) {
+            uint32_t i = 0;
+            for (; i < ptsCnt * 2; ++i) {
+                auto value = coords[i] * _tvgPathScales[precision];
+                if (!(fabs(value) < 2147483647.0) || _tvgDequantize(llround(value), precision) != coords[i]) break;
+            }
+            if (i == ptsCnt * 2) return precision;
+        }
+        return -1;
+    }
+
+
+    static char* writeVarint(char* ptr, uint64_t value)
+    {
+        while (value >= 0x80) {
+            *ptr++ = static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        *ptr++ = static_cast<char>(value);
+        return ptr;
+    }
+
+
+    //Only if it's smaller than the raw one.
+    ByteCounter serializeShapeQuantizedPath(const PathCommand* cmds, uint32_t cmdCnt, const Point* pts, uint32_t ptsCnt)
+    {
+        auto precision = pathPrecision(pts, ptsCnt);
+        if (precision < 0) return 0;
+
+        ByteCounter rawByteCnt = 2 * sizeof(uint32_t) + cmdCnt * sizeof(cmds[0]) + ptsCnt * sizeof(pts[0]);
+        auto data = static_cast<char*>(malloc(2 * 10 + 1 + (cmdCnt + 3) / 4 + ptsCnt * 2 * 10));
+        if (!data) return 0;
+
+        auto ptr = writeVarint(data, cmdCnt);
+        ptr = writeVarint(ptr, ptsCnt);
+        *ptr++ = static_cast<char>(precision);
+
+        memset(ptr, 0, (cmdCnt + 3) / 4);
+        for (uint32_t i = 0; i < cmdCnt; ++i) {
+            ptr[i >> 2] |= static_cast<char>((static_cast<uint8_t>(cmds[i]) & 0x03) << ((i & 0x03) << 1));
+        }
+        ptr += (cmdCnt + 3) / 4;
+
+        int64_t x = 0, y = 0;
+        for (uint32_t i = 0; i < ptsCnt; ++i) {
+            auto qx = static_cast<int64_t>(llround(pts[i].x * _tvgPathScales[precision]));
+            auto qy = static_cast<int64_t>(llround(pts[i].y * _tvgPathScales[precision]));
+            auto dx = qx - x;
+            auto dy = qy - y;
+            ptr = writeVarint(ptr, (static_cast<uint64_t>(dx) << 1) ^ static_cast<uint64_t>(dx >> 63));
+            ptr = writeVarint(ptr, (static_cast<uint64_t>(dy) << 1) ^ static_cast<uint64_t>(dy >> 63));
+            x = qx;
+            y = qy;
+        }
+
+        ByteCounter dataByteCnt = ptr - data;
+        ByteCounter pathByteCnt = 0;
+        if (dataByteCnt < rawByteCnt) pathByteCnt = writeMember(TVG_SHAPE_QUANTIZED_PATH_INDICATOR, dataByteCnt, data);
+        free(data);
+        return pathByteCnt;
+    }
+
+
     ByteCounter serializeShapePath(const Shape* shape)
     {
         const PathCommand* cmds = nullptr;
@@ -331,6 +496,8 @@ struct Saver::Impl
 
         if (!cmds || !pts || !cmdCnt || !ptsCnt) return 0;
 
+        if (auto pathByteCnt = serializeShapeQuantizedPath(cmds, cmdCnt, pts, ptsCnt)) return pathByteCnt;
+
         ByteCounter pathDataByteCnt = 0;
 
         writeMemberIndicator(TVG_SHAPE_PATH_INDICATOR);
@@ -387,7 +554,17 @@ struct Saver::Impl
     {
         auto picture = static_cast<const Picture*>(paint);
         if (!picture) return 0;
-        auto pixels = picture->data();
+        //The pixels not taken by the picture yet are read from its loader, the picture is left as it is.
+        auto image = P(picture)->image;
+        auto pixels = P(picture)->pixels;
+        if (!pixels && P(picture)->source(image)) pixels = image.buffer;
+
+        //The binary format keeps only 32-bit pixels, the compact ones are expanded row by row.
+        uint32_t* row = nullptr;
+        if (pixels && image.format != Picture::Color32) {
+            row = static_cast<uint32_t*>(malloc(image.w * sizeof(uint32_t)));
+            if (!row) return 0;
+        }
 
         ByteCounter pictureDataByteCnt = 0;
 
@@ -395,12 +572,8 @@ struct Saver::Impl
         skipInBufferMemberDataSize();
 
         if (pixels) {
-            //TODO - loader expects uints
-            float vw, vh;
-            picture->viewbox(nullptr, nullptr, &vw, &vh);
-
-            uint32_t w = static_cast<uint32_t>(vw);
-            uint32_t h = static_cast<uint32_t>(vh);
+            auto w = image.w;
+            auto h = image.h;
             ByteCounter wByteCnt = sizeof(w); // same as h size
             ByteCounter pixelsByteCnt = w * h * sizeof(pixels[0]);
 
@@ -408,7 +581,18 @@ struct Saver::Impl
             writeMemberDataSize(2 * wByteCnt + pixelsByteCnt);
             pictureDataByteCnt += writeMemberData(&w, wByteCnt);
             pictureDataByteCnt += writeMemberData(&h, wByteCnt);
-            pictureDataByteCnt += writeMemberData(pixels, pixelsByteCnt);
+            //Pack the rows, the source might be a region of a larger image.
+            if (!row) {
+                for (uint32_t y = 0; y < h; ++y) {
+                    pictureDataByteCnt += writeMemberData(pixels + y * image.stride, w * sizeof(pixels[0]));
+                }
+            } else {
+                for (uint32_t y = 0; y < h; ++y) {
+                    P(picture)->expandRow(image, y, row);
+                    pictureDataByteCnt += writeMemberData(row, w * sizeof(row[0]));
+                }
+                free(row);
+            }
             pictureDataByteCnt += TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE;
         } else {
             pictureDataByteCnt += serializeChildren(paint);
@@ -457,6 +641,9 @@ struct Saver::Impl
     {
         if (!paint) return 0;
         ByteCounter dataByteCnt = 0;
+        auto compressCnt = this->compressCnt;
+        ++depth;
+        if (sceneDepth == 0 && paint->id() == TVG_CLASS_ID_SCENE) sceneDepth = depth;
 
         switch (paint->id()) {
             case TVG_CLASS_ID_SHAPE: {
@@ -473,21 +660,47 @@ struct Saver::Impl
             }
         }
 
+        /* The paint is compressed once, not again with the ones holding it,
+           and only as a whole, before any part of it goes out to the file. */
+        if (dataByteCnt >= TVG_COMPRESS_MIN_SIZE && dataByteCnt <= size && compressCnt == this->compressCnt) {
+            dataByteCnt = compressBlock(dataByteCnt);
+            ++this->compressCnt;
+        }
+
+        /* A paint below the first scene is final but its byte counter, whatever the root is.
+           The ones holding it are not compressed any more once a part of them is written out. */
+        if (sceneDepth > 0 && depth > sceneDepth && size >= TVG_FLUSH_SIZE) flushBuffer();
+        --depth;
+
         return dataByteCnt;
     }
 
 
-    bool save(const Paint* paint, const std::string& path)
+    /* Written aside and renamed, the file in the path is replaced only when it's complete.
+       The name is of this process and this save, the others write their own. */
+    bool save(const Paint* paint, const std::string& path, const Loader* source = nullptr)
     {
-        if (!prepareBuffer()) return false;
-        if (!writeHeader()) return false;
+        static atomic<uint32_t> count{0};
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), ".%d.%u.tmp", static_cast<int>(getpid()), count++);
+        auto temp = path + suffix;
 
-        if (serialize(paint) == 0) return false;
+        file.open(temp, ios::out | ios::trunc | ios::binary);
+        if (!file.is_open()) return false;
 
-        if (!saveBufferToFile(path)) return false;
+        auto ret = prepareBuffer() && writeHeader(source) && serialize(paint) > 0 && flushBuffer();
+        file.close();
         clearBuffer();
 
-        return true;
+        if (ret && !file.fail()) {
+#ifdef _WIN32
+            //Not replaced by the rename there.
+            remove(path.c_str());
+#endif
+            if (rename(temp.c_str(), path.c_str()) == 0) return true;
+        }
+        remove(temp.c_str());
+        return false;
     }
 };
 
@@ -88,7 +88,7 @@ Result Shape::appendPath(const PathCommand *cmds, uint32_t cmdCnt, const Point*
 {
     if (cmdCnt == 0 || ptsCnt == 0 || !pts || !ptsCnt) return Result::InvalidArguments;
 
-    pImpl->path.grow(cmdCnt, ptsCnt);
+    if (!pImpl->path.grow(cmdCnt, ptsCnt)) return Result::FailedAllocation;
     pImpl->path.append(cmds, cmdCnt, pts, ptsCnt);
 
     pImpl->flag |= RenderUpdateFlag::Path;
@@ -23,6 +23,8 @@
 #define _TVG_SHAPE_IMPL_H_
 
 #include <memory.h>
+#include <new>
+#include <atomic>
 #include "tvgPaint.h"
 
 /************************************************************************/
@@ -63,6 +65,37 @@ struct ShapeStroke
 };
 
 
+//Read-only path arrays in one block, shared by the paths until the last of them is gone.
+struct ShapePathSource
+{
+    atomic<uint32_t> refCnt{1};
+
+    static ShapePathSource* gen(size_t size)
+    {
+        auto mem = malloc(sizeof(ShapePathSource) + size);
+        if (!mem) return nullptr;
+        return new(mem) ShapePathSource;
+    }
+
+    void* data()
+    {
+        return this + 1;
+    }
+
+    void ref()
+    {
+        ++refCnt;
+    }
+
+    void unref()
+    {
+        if (--refCnt > 0) return;
+        this->~ShapePathSource();
+        free(this);
+    }
+};
+
+
 struct ShapePath
 {
     PathCommand* cmds = nullptr;
@@ -73,18 +106,75 @@ struct ShapePath
     uint32_t ptsCnt = 0;
     uint32_t reservedPtsCnt = 0;
 
+    ShapePathSource* source = nullptr;      //the owner of the arrays when they are shared
+
     ~ShapePath()
     {
-        if (cmds) free(cmds);
-        if (pts) free(pts);
+        release();
     }
 
     ShapePath()
     {
     }
 
+    void release()
+    {
+        if (source) {
+            source->unref();
+            source = nullptr;
+        } else {
+            if (cmds) free(cmds);
+            if (pts) free(pts);
+        }
+        cmds = nullptr;
+        pts = nullptr;
+        reservedCmdCnt = 0;
+        reservedPtsCnt = 0;
+    }
+
+    //Refers the arrays of the source instead of copying them.
+    void share(ShapePathSource* source, PathCommand* cmds, uint32_t cmdCnt, Point* pts, uint32_t ptsCnt)
+    {
+        release();
+        source->ref();
+        this->source = source;
+        this->cmds = cmds;
+        this->cmdCnt = cmdCnt;
+        this->pts = pts;
+        this->ptsCnt = ptsCnt;
+    }
+
+    //Copy on write, the path takes its own arrays before it changes.
+    bool detach()
+    {
+        auto cmds = static_cast<PathCommand*>(malloc(sizeof(PathCommand) * cmdCnt));
+        auto pts = static_cast<Point*>(malloc(sizeof(Point) * ptsCnt));
+
+        //Keeps the shared ones, unless the copies are taken.
+        if ((!cmds && cmdCnt > 0) || (!pts && ptsCnt > 0)) {
+            free(cmds);
+            free(pts);
+            return false;
+        }
+        if (cmds) memcpy(cmds, this->cmds, sizeof(PathCommand) * cmdCnt);
+        if (pts) memcpy(pts, this->pts, sizeof(Point) * ptsCnt);
+
+        source->unref();
+        source = nullptr;
+        this->cmds = cmds;
+        this->pts = pts;
+        reservedCmdCnt = cmdCnt;
+        reservedPtsCnt = ptsCnt;
+        return true;
+    }
+
     void duplicate(const ShapePath* src)
     {
+        if (src->source) {
+            share(src->source, src->cmds, src->cmdCnt, src->pts, src->ptsCnt);
+            return;
+        }
+
         cmdCnt = src->cmdCnt;
         reservedCmdCnt = src->reservedCmdCnt;
         ptsCnt = src->ptsCnt;
@@ -102,28 +192,32 @@ struct ShapePath
         memcpy(pts, src->pts, sizeof(Point) * ptsCnt);
     }
 
-    void reserveCmd(uint32_t cmdCnt)
+    bool reserveCmd(uint32_t cmdCnt)
     {
-        if (cmdCnt <= reservedCmdCnt) return;
+        if (source && !detach()) return false;
+        if (cmdCnt <= reservedCmdCnt) return true;
         reservedCmdCnt = cmdCnt;
         cmds = static_cast<PathCommand*>(realloc(cmds, sizeof(PathCommand) * reservedCmdCnt));
+        return true;
     }
 
-    void reservePts(uint32_t ptsCnt)
+    bool reservePts(uint32_t ptsCnt)
     {
-        if (ptsCnt <= reservedPtsCnt) return;
+        if (source && !detach()) return false;
+        if (ptsCnt <= reservedPtsCnt) return true;
         reservedPtsCnt = ptsCnt;
         pts = static_cast<Point*>(realloc(pts, sizeof(Point) * reservedPtsCnt));
+        return true;
     }
 
-    void grow(uint32_t cmdCnt, uint32_t ptsCnt)
+    bool grow(uint32_t cmdCnt, uint32_t ptsCnt)
     {
-        reserveCmd(this->cmdCnt + cmdCnt);
-        reservePts(this->ptsCnt + ptsCnt);
+        return reserveCmd(this->cmdCnt + cmdCnt) && reservePts(this->ptsCnt + ptsCnt);
     }
 
     void reset()
     {
+        if (source) release();
         cmdCnt = 0;
         ptsCnt = 0;
     }
@@ -138,8 +232,8 @@ struct ShapePath
 
     void moveTo(float x, float y)
     {
-        if (cmdCnt + 1 > reservedCmdCnt) reserveCmd((cmdCnt + 1) * 2);
-        if (ptsCnt + 2 > reservedPtsCnt) reservePts((ptsCnt + 2) * 2);
+        if (cmdCnt + 1 > reservedCmdCnt && !reserveCmd((cmdCnt + 1) * 2)) return;
+        if (ptsCnt + 2 > reservedPtsCnt && !reservePts((ptsCnt + 2) * 2)) return;
 
         cmds[cmdCnt++] = PathCommand::MoveTo;
         pts[ptsCnt++] = {x, y};
@@ -147,8 +241,8 @@ struct ShapePath
 
     void lineTo(float x, float y)
     {
-        if (cmdCnt + 1 > reservedCmdCnt) reserveCmd((cmdCnt + 1) * 2);
-        if (ptsCnt + 2 > reservedPtsCnt) reservePts((ptsCnt + 2) * 2);
+        if (cmdCnt + 1 > reservedCmdCnt && !reserveCmd((cmdCnt + 1) * 2)) return;
+        if (ptsCnt + 2 > reservedPtsCnt && !reservePts((ptsCnt + 2) * 2)) return;
 
         cmds[cmdCnt++] = PathCommand::LineTo;
         pts[ptsCnt++] = {x, y};
@@ -156,8 +250,8 @@ struct ShapePath
 
     void cubicTo(float cx1, float cy1, float cx2, float cy2, float x, float y)
     {
-        if (cmdCnt + 1 > reservedCmdCnt) reserveCmd((cmdCnt + 1) * 2);
-        if (ptsCnt + 3 > reservedPtsCnt) reservePts((ptsCnt + 3) * 2);
+        if (cmdCnt + 1 > reservedCmdCnt && !reserveCmd((cmdCnt + 1) * 2)) return;
+        if (ptsCnt + 3 > reservedPtsCnt && !reservePts((ptsCnt + 3) * 2)) return;
 
         cmds[cmdCnt++] = PathCommand::CubicTo;
         pts[ptsCnt++] = {cx1, cy1};
@@ -169,7 +263,7 @@ struct ShapePath
     {
         if (cmdCnt > 0 && cmds[cmdCnt - 1] == PathCommand::Close) return;
 
-        if (cmdCnt + 1 > reservedCmdCnt) reserveCmd((cmdCnt + 1) * 2);
+        if (cmdCnt + 1 > reservedCmdCnt && !reserveCmd((cmdCnt + 1) * 2)) return;
         cmds[cmdCnt++] = PathCommand::Close;
     }
 
@@ -256,6 +350,17 @@ struct Shape::Impl
         return ret;
     }
 
+    //The first path of the shape is taken as it is, the following ones are appended.
+    void sharePath(ShapePathSource* source, PathCommand* cmds, uint32_t cmdCnt, Point* pts, uint32_t ptsCnt)
+    {
+        if (path.cmdCnt > 0 || path.ptsCnt > 0) {
+            if (path.grow(cmdCnt, ptsCnt)) path.append(cmds, cmdCnt, pts, ptsCnt);
+        } else {
+            path.share(source, cmds, cmdCnt, pts, ptsCnt);
+        }
+        flag |= RenderUpdateFlag::Path;
+    }
+
     bool strokeWidth(float width)
     {
         //TODO: Size Exception?
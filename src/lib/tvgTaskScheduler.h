@@ -52,9 +52,9 @@ public:
 
     void done()
     {
-        if (!pending) return;
-
+        //Any threads may wait for the same task, the pictures share the loader.
         unique_lock<mutex> lock(mtx);
+        if (!pending) return;
         while (!ready) cv.wait(lock);
         pending = false;
     }
@@ -69,11 +69,12 @@ private:
 
         lock_guard<mutex> lock(mtx);
         ready = true;
-        cv.notify_one();
+        cv.notify_all();
     }
 
     void prepare()
     {
+        lock_guard<mutex> lock(mtx);
         ready = false;
         pending = true;
     }
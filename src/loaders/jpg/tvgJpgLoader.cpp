@@ -29,9 +29,20 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+//Swap the red and the blue channels for the other colorspace.
+static void _swapChannels(uint32_t* buffer, uint32_t len)
+{
+    for (auto dst = buffer; dst < buffer + len; ++dst) {
+        auto c = *dst;
+        *dst = (c & 0xff00ff00) | ((c & 0x00ff0000) >> 16) | ((c & 0x000000ff) << 16);
+    }
+}
+
+
 void JpgLoader::clear()
 {
     if (freeData) free(data);
+    file.close();
     data = nullptr;
     size = 0;
     freeData = false;
@@ -49,6 +60,7 @@ JpgLoader::JpgLoader()
 
 JpgLoader::~JpgLoader()
 {
+    this->done();
     if (freeData) free(data);
     tjDestroy(jpegDecompressor);
 
@@ -61,37 +73,23 @@ bool JpgLoader::open(const string& path)
 {
     clear();
 
-    auto jpegFile = fopen(path.c_str(), "rb");
-    if (!jpegFile) return false;
-
-    auto ret = false;
-
-    //determine size
-    if (fseek(jpegFile, 0, SEEK_END) < 0) goto finalize;
-    if (((size = ftell(jpegFile)) < 1)) goto finalize;
-    if (fseek(jpegFile, 0, SEEK_SET)) goto finalize;
-
-    data = (unsigned char *) malloc(size);
-    if (!data) goto finalize;
+    //Decompress over the file pages directly.
+    if (!file.open(path)) return false;
 
-    if (fread(data, size, 1, jpegFile) < 1) goto failure;
+    data = (unsigned char *) file.data;
+    size = file.size;
 
     int width, height, subSample, colorSpace;
-    if (tjDecompressHeader3(jpegDecompressor, data, size, &width, &height, &subSample, &colorSpace) < 0) goto failure;
+    if (tjDecompressHeader3(jpegDecompressor, data, size, &width, &height, &subSample, &colorSpace) < 0) {
+        clear();
+        return false;
+    }
 
     vw = w = static_cast<float>(width);
     vh = h = static_cast<float>(height);
-    ret = true;
-    freeData = true;
-
-    goto finalize;
-
-failure:
-    clear();
+    pixelFormat = (colorSpace == TJCS_GRAY) ? Picture::L8 : Picture::Color32;
 
-finalize:
-    fclose(jpegFile);
-    return ret;
+    return true;
 }
 
 
@@ -113,6 +111,7 @@ bool JpgLoader::open(const char* data, uint32_t size, bool copy)
 
     vw = w = static_cast<float>(width);
     vh = h = static_cast<float>(height);
+    pixelFormat = (colorSpace == TJCS_GRAY) ? Picture::L8 : Picture::Color32;
     this->size = size;
 
     return true;
@@ -121,29 +120,114 @@ bool JpgLoader::open(const char* data, uint32_t size, bool copy)
 
 bool JpgLoader::read()
 {
-    if (image) tjFree(image);
-    image = (unsigned char *)tjAlloc(static_cast<int>(w) * static_cast<int>(h) * tjPixelSize[TJPF_BGRX]);
-    if (!image) return false;
+    if (!data || size == 0) return false;
 
-    //decompress jpg image
-    if (tjDecompress2(jpegDecompressor, data, size, image, static_cast<int>(w), 0, static_cast<int>(h), TJPF_BGRX, 0) < 0) {
-        tjFree(image);
-        image = nullptr;
-        return false;
+    //Decoded by the workers, or right here without them.
+    if (TaskScheduler::threads() > 0) {
+        TaskScheduler::request(this);
+        return true;
     }
+    run(0);
 
-    return true;
+    return image != nullptr;
 }
 
 
 bool JpgLoader::close()
 {
+    this->done();
     clear();
     return true;
 }
 
 
+void JpgLoader::wait()
+{
+    this->done();
+}
+
+
+void JpgLoader::run(unsigned tid)
+{
+    if (image) tjFree(image);
+
+    //Grayscale image is kept in 8-bit luminance, a quarter of the memory.
+    //Otherwise, turbojpeg arranges the channels in the order of the target colorspace.
+    auto pixelType = TJPF_GRAY;
+    if (pixelFormat != Picture::L8) pixelType = (cs == SwCanvas::ABGR8888) ? TJPF_RGBX : TJPF_BGRX;
+
+    //turbojpeg takes the scaling factor which gives exactly this size
+    auto width = static_cast<int>(stride());
+    auto height = (static_cast<int>(h) + static_cast<int>(step) - 1) / static_cast<int>(step);
+
+    image = (unsigned char *)tjAlloc(width * height * tjPixelSize[pixelType]);
+    if (!image) return;
+
+    //decompress jpg image
+    if (tjDecompress2(jpegDecompressor, data, size, image, width, 0, height, pixelType, 0) < 0) {
+        tjFree(image);
+        image = nullptr;
+    }
+}
+
+
 const uint32_t* JpgLoader::pixels()
 {
+    this->done();
     return (const uint32_t*) image;
 }
+
+
+uint32_t JpgLoader::stride()
+{
+    return (static_cast<uint32_t>(w) + step - 1) / step;
+}
+
+
+uint32_t JpgLoader::sampling()
+{
+    return step;
+}
+
+
+void JpgLoader::fit(float w, float h)
+{
+    auto sx = w / this->w;
+    auto sy = h / this->h;
+    auto scale = sx < sy ? sx : sy;
+
+    //The smallest of the DCT scaling factors 1/2, 1/4 and 1/8 which still covers the drawn size.
+    auto width = static_cast<uint32_t>(this->w);
+    auto height = static_cast<uint32_t>(this->h);
+    step = 1;
+    for (uint32_t s = 2; s <= 8; s *= 2) {
+        if ((width + s - 1) / s < width * scale || (height + s - 1) / s < height * scale) break;
+        step = s;
+    }
+}
+
+
+bool JpgLoader::arranged(uint32_t cs)
+{
+    this->done();
+    return !image || pixelFormat != Picture::Color32 || this->cs == cs;
+}
+
+
+bool JpgLoader::colorspace(uint32_t cs)
+{
+    this->done();
+    if (this->cs == cs) return false;
+    this->cs = cs;
+
+    if (!image || pixelFormat != Picture::Color32) return false;
+    auto height = (static_cast<uint32_t>(h) + step - 1) / step;
+    _swapChannels(reinterpret_cast<uint32_t*>(image), stride() * height);
+    return true;
+}
+
+
+Picture::PixelFormat JpgLoader::format()
+{
+    return pixelFormat;
+}
@@ -22,10 +22,12 @@
 #ifndef _TVG_JPG_LOADER_H_
 #define _TVG_JPG_LOADER_H_
 
+#include "tvgTaskScheduler.h"
+#include "tvgFileSource.h"
+
 using tjhandle = void*;
 
-//TODO: Use Task?
-class JpgLoader : public Loader
+class JpgLoader : public Loader, public Task
 {
 public:
     JpgLoader();
@@ -36,16 +38,28 @@ public:
     bool open(const char* data, uint32_t size, bool copy) override;
     bool read() override;
     bool close() override;
+    void wait() override;
+    void run(unsigned tid) override;
 
     const uint32_t* pixels() override;
+    uint32_t stride() override;
+    uint32_t sampling() override;
+    void fit(float w, float h) override;
+    bool arranged(uint32_t cs) override;
+    bool colorspace(uint32_t cs) override;
+    Picture::PixelFormat format() override;
 
 private:
     void clear();
 
     tjhandle jpegDecompressor;
+    FileSource file;
     unsigned char* data = nullptr;
     unsigned char *image = nullptr;
     unsigned long size = 0;
+    Picture::PixelFormat pixelFormat = Picture::Color32;
+    uint32_t cs = SwCanvas::ARGB8888;
+    uint32_t step = 1;              //decoded in 1/step of the size
     bool freeData = false;
 };
 
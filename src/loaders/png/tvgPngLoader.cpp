@@ -20,9 +20,145 @@
  * SOFTWARE.
  */
 
+#include <memory.h>
 #include "tvgLoaderMgr.h"
 #include "tvgPngLoader.h"
 
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+    #include <immintrin.h>
+#endif
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+/* The raster engine blends the premultiplied colors,
+   while the png pixels are decoded in straight alpha. */
+static void _premultiply(uint32_t* buffer, uint32_t len)
+{
+    auto dst = buffer;
+    auto end = buffer + len;
+
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+    //4 pixels at once, in 16-bit channels
+    auto zero = _mm_setzero_si128();
+    auto round = _mm_set1_epi16(0xff);
+    for (; dst + 4 <= end; dst += 4) {
+        auto px = _mm_loadu_si128((__m128i*)dst);
+        auto lo = _mm_unpacklo_epi8(px, zero);
+        auto hi = _mm_unpackhi_epi8(px, zero);
+        //Broadcast the alpha to the color channels, keep the alpha channel as it is.
+        auto loA = _mm_blend_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xff), 0xff), round, 0x88);
+        auto hiA = _mm_blend_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xff), 0xff), round, 0x88);
+        lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, loA), round), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, hiA), round), 8);
+        _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; dst < end; ++dst) {
+        auto c = *dst;
+        auto a = (c >> 24);
+        if (a == 255) continue;
+        auto rb = ((((c & 0x00ff00ff) * a) + 0x00ff00ff) >> 8) & 0x00ff00ff;
+        auto g = ((((c >> 8) & 0xff) * a) + 0xff) & 0xff00;
+        *dst = (c & 0xff000000) | rb | g;
+    }
+}
+
+
+//Swap the red and the blue channels for the other colorspace.
+static void _swapChannels(uint32_t* buffer, uint32_t len)
+{
+    for (auto dst = buffer; dst < buffer + len; ++dst) {
+        auto c = *dst;
+        *dst = (c & 0xff00ff00) | ((c & 0x00ff0000) >> 16) | ((c & 0x000000ff) << 16);
+    }
+}
+
+
+/* Images over this number of pixels are not decoded as a whole,
+   but streamed row by row to decode just the visible regions. */
+static constexpr uint32_t STREAMING_SIZE = 4096 * 4096;
+
+/* Rows of the interlaced image are spread over the passes, it can't be streamed.
+   The interlace method is the last field of the IHDR chunk, which must be the first one. */
+static bool _streamable(const uint8_t* header, uint32_t size)
+{
+    if (size < 29) return false;
+    if (memcmp(header + 12, "IHDR", 4)) return false;
+    return header[28] == 0;
+}
+
+
+static void _release(png_structp* png, png_infop* info, FILE* file, uint32_t* row)
+{
+    png_destroy_read_struct(png, info, nullptr);
+    if (file) fclose(file);
+    free(row);
+}
+
+
+struct PngSource
+{
+    const uint8_t* data;
+    uint32_t size;
+    uint32_t offset;
+};
+
+
+static void _readSource(png_structp png, png_bytep out, png_size_t len)
+{
+    auto source = static_cast<PngSource*>(png_get_io_ptr(png));
+    if (source->offset + len > source->size) png_error(png, "Read beyond the png data");
+    memcpy(out, source->data + source->offset, len);
+    source->offset += len;
+}
+
+/* Read the rows up to the region, keep the sampled ones in the buffer.
+   The setjmp() scope is kept in here, no local of the caller lives across the longjmp() of libpng. */
+static bool _readRegion(png_structp png, png_infop info, uint32_t* buffer, uint32_t* row, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t step, uint32_t cs)
+{
+    //libpng jumps here on errors
+    if (setjmp(png_jmpbuf(png))) return false;
+
+    png_read_info(png, info);
+
+    /* Corrected into sRGB as png_image_finish_read() does for the whole image: the file without the gamma
+       is taken as sRGB, or as linear in 16 bits. The first call sets the default of the file, the second the output. */
+    auto bitDepth = png_get_bit_depth(png, info);
+    png_set_alpha_mode(png, PNG_ALPHA_PNG, (bitDepth == 16) ? PNG_GAMMA_LINEAR : PNG_DEFAULT_sRGB);
+    png_set_alpha_mode(png, PNG_ALPHA_PNG, PNG_DEFAULT_sRGB);
+
+    //Expand all the color types into the 8-bit channels of the target colorspace.
+    auto colorType = png_get_color_type(png, info);
+    if (colorType == PNG_COLOR_TYPE_PALETTE) png_set_palette_to_rgb(png);
+    if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8) png_set_expand_gray_1_2_4_to_8(png);
+    if (png_get_valid(png, info, PNG_INFO_tRNS)) png_set_tRNS_to_alpha(png);
+    if (bitDepth == 16) png_set_scale_16(png);
+    if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA) png_set_gray_to_rgb(png);
+    png_set_filler(png, 0xff, PNG_FILLER_AFTER);
+    if (cs == SwCanvas::ARGB8888) png_set_bgr(png);
+    auto translucent = (colorType & PNG_COLOR_MASK_ALPHA) || png_get_valid(png, info, PNG_INFO_tRNS);
+    png_read_update_info(png, info);
+
+    //Read the rows in sequence up to the region, keep the sampled ones only.
+    auto rw = (w + step - 1) / step;
+    auto dst = buffer;
+    for (uint32_t py = 0; py < y + h; ++py) {
+        png_read_row(png, (png_bytep)row, nullptr);
+        if (py < y || (py - y) % step) continue;
+        auto src = row + x;
+        for (uint32_t i = 0; i < rw; ++i, src += step) dst[i] = *src;
+        if (translucent) _premultiply(dst, rw);
+        dst += rw;
+    }
+    return true;
+}
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
 PngLoader::PngLoader()
 {
     image = static_cast<png_imagep>(calloc(1, sizeof(png_image)));
@@ -32,10 +168,14 @@ PngLoader::PngLoader()
 
 PngLoader::~PngLoader()
 {
+    this->done();
     if (content) {
         free((void*)content);
         content = nullptr;
     }
+    if (freeData) free((void*)data);
+    //Never decoded, the header reader is still open.
+    png_image_free(image);
     free(image);
 }
 
@@ -48,6 +188,20 @@ bool PngLoader::open(const string& path)
     vw = w = image->width;
     vh = h = image->height;
 
+    //Keep the path only, the rows are read again from the file on demand.
+    if (static_cast<uint64_t>(image->width) * image->height > STREAMING_SIZE) {
+        auto file = fopen(path.c_str(), "rb");
+        if (file) {
+            uint8_t header[29];
+            auto size = static_cast<uint32_t>(fread(header, 1, sizeof(header), file));
+            fclose(file);
+            if (_streamable(header, size)) {
+                this->path = path;
+                streaming = true;
+            }
+        }
+    }
+
     return true;
 }
 
@@ -55,37 +209,155 @@ bool PngLoader::open(const char* data, uint32_t size, bool copy)
 {
     image->opaque = NULL;
 
-    if (!png_image_begin_read_from_memory(image, data, size)) return false;
+    if (size < 8 || png_sig_cmp((png_const_bytep)data, 0, 8)) return false;
+
+    //The pixels are decoded later by the task or the rows on demand, keep the data till then.
+    if (copy) {
+        this->data = (uint8_t*)malloc(size);
+        if (!this->data) return false;
+        memcpy((void*)this->data, data, size);
+        freeData = true;
+    } else {
+        this->data = (const uint8_t*)data;
+    }
+    this->size = size;
+
+    if (!png_image_begin_read_from_memory(image, this->data, size)) return false;
 
     vw = w = image->width;
     vh = h = image->height;
 
+    if (static_cast<uint64_t>(image->width) * image->height > STREAMING_SIZE && _streamable(this->data, size)) streaming = true;
+
     return true;
 }
 
 bool PngLoader::read()
+{
+    //Decoded by the regions, the header reader is no longer needed.
+    if (streaming) {
+        png_image_free(image);
+        return true;
+    }
+
+    //Decoded by the workers, or right here without them.
+    if (TaskScheduler::threads() > 0) {
+        TaskScheduler::request(this);
+        return true;
+    }
+    run(0);
+
+    return content != nullptr;
+}
+
+bool PngLoader::close()
+{
+    this->done();
+    png_image_free(image);
+    return true;
+}
+
+void PngLoader::wait()
+{
+    this->done();
+}
+
+
+void PngLoader::run(unsigned tid)
 {
     png_bytep buffer;
-    image->format = PNG_FORMAT_BGRA;
+    //Opaque grayscale image is kept in 8-bit luminance, a quarter of the memory.
+    if (!(image->format & (PNG_FORMAT_FLAG_COLOR | PNG_FORMAT_FLAG_ALPHA))) {
+        image->format = PNG_FORMAT_GRAY;
+        pixelFormat = Picture::L8;
+    } else {
+        //libpng arranges the channels in the order of the target colorspace.
+        alpha = (image->format & PNG_FORMAT_FLAG_ALPHA);
+        image->format = (cs == SwCanvas::ABGR8888) ? PNG_FORMAT_RGBA : PNG_FORMAT_BGRA;
+        pixelFormat = Picture::Color32;
+    }
     buffer = static_cast<png_bytep>(malloc(PNG_IMAGE_SIZE((*image))));
     if (!buffer) {
         // out of memory, only time when libpng doesnt free its data
         png_image_free(image);
-        return false;
+        return;
+    }
+    if (!png_image_finish_read(image, NULL, buffer, 0, NULL)) {
+        free(buffer);
+        return;
     }
-    if (!png_image_finish_read(image, NULL, buffer, 0, NULL)) return false;
+    if (alpha) _premultiply(reinterpret_cast<uint32_t*>(buffer), image->width * image->height);
     content = reinterpret_cast<uint32_t*>(buffer);
+}
 
-    return true;
+const uint32_t* PngLoader::pixels()
+{
+    this->done();
+    return this->content;
 }
 
-bool PngLoader::close()
+
+uint32_t* PngLoader::decode(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t step, uint32_t cs)
 {
-    png_image_free(image);
+    if (!streaming || step == 0 || w == 0 || h == 0) return nullptr;
+
+    auto width = static_cast<uint32_t>(this->w);
+    auto height = static_cast<uint32_t>(this->h);
+    if (x + w > width || y + h > height) return nullptr;
+
+    auto rw = (w + step - 1) / step;
+    auto rh = (h + step - 1) / step;
+
+    //Allocate all before reading, longjmp() of libpng would skip the local changes.
+    auto buffer = static_cast<uint32_t*>(malloc(sizeof(uint32_t) * rw * rh));
+    auto row = static_cast<uint32_t*>(malloc(sizeof(uint32_t) * width));
+    auto png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    auto info = png ? png_create_info_struct(png) : nullptr;
+    FILE* file = path.empty() ? nullptr : fopen(path.c_str(), "rb");
+    PngSource source = {data, size, 0};
+
+    if (!buffer || !row || !info || (!file && !data)) {
+        _release(&png, &info, file, row);
+        free(buffer);
+        return nullptr;
+    }
+
+    if (file) png_init_io(png, file);
+    else png_set_read_fn(png, &source, _readSource);
+
+    if (!_readRegion(png, info, buffer, row, x, y, w, h, step, cs)) {
+        _release(&png, &info, file, row);
+        free(buffer);
+        return nullptr;
+    }
+
+    _release(&png, &info, file, row);
+
+    return buffer;
+}
+
+
+bool PngLoader::arranged(uint32_t cs)
+{
+    this->done();
+    return !content || pixelFormat != Picture::Color32 || this->cs == cs;
+}
+
+
+bool PngLoader::colorspace(uint32_t cs)
+{
+    this->done();
+    if (this->cs == cs) return false;
+    this->cs = cs;
+
+    if (!content || pixelFormat != Picture::Color32) return false;
+    _swapChannels(const_cast<uint32_t*>(content), static_cast<uint32_t>(w * h));
     return true;
 }
 
-const uint32_t* PngLoader::pixels()
+
+Picture::PixelFormat PngLoader::format()
 {
-    return this->content;
+    this->done();
+    return this->pixelFormat;
 }
@@ -23,9 +23,9 @@
 #define _TVG_PNG_LOADER_H_
 
 #include <png.h>
+#include "tvgTaskScheduler.h"
 
-//OPTIMIZE ME: Use Task?
-class PngLoader : public Loader
+class PngLoader : public Loader, public Task
 {
 public:
     PngLoader();
@@ -36,12 +36,27 @@ public:
     bool open(const char* data, uint32_t size, bool copy) override;
     bool read() override;
     bool close() override;
+    void wait() override;
+    void run(unsigned tid) override;
 
     const uint32_t* pixels() override;
+    bool arranged(uint32_t cs) override;
+    bool colorspace(uint32_t cs) override;
+    uint32_t* decode(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t step, uint32_t cs) override;
+    Picture::PixelFormat format() override;
 
 private:
     png_imagep image = nullptr;
     const uint32_t* content = nullptr;
+    Picture::PixelFormat pixelFormat = Picture::Color32;
+    uint32_t cs = SwCanvas::ARGB8888;
+    bool alpha = false;
+
+    //Source of the streaming image
+    string path;
+    const uint8_t* data = nullptr;
+    uint32_t size = 0;
+    bool freeData = false;
 };
 
 #endif //_TVG_PNG_LOADER_H_
@@ -28,6 +28,16 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+static uint32_t _pixelSize(Picture::PixelFormat format)
+{
+    switch (format) {
+        case Picture::A8:
+        case Picture::L8: return sizeof(uint8_t);
+        case Picture::RGB565: return sizeof(uint16_t);
+        default: return sizeof(uint32_t);
+    }
+}
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -41,20 +51,34 @@ RawLoader::~RawLoader()
 }
 
 
-bool RawLoader::open(const uint32_t* data, uint32_t w, uint32_t h, bool copy)
+bool RawLoader::open(const void* data, uint32_t w, uint32_t h, uint32_t stride, Picture::PixelFormat format, bool copy)
 {
-    if (!data || w == 0 || h == 0) return false;
+    if (!data || w == 0 || h == 0 || stride < w) return false;
 
     this->w = vw = w;
     this->h = vh = h;
     this->copy = copy;
+    this->contentFormat = format;
 
+    //Copy the pixels in a compact form, skipping the paddings of the rows.
     if (copy) {
-        content = (uint32_t*)malloc(sizeof(uint32_t) * vw * vh);
-        if (!content) return false;
-        memcpy((void*)content, data, sizeof(uint32_t) * vw * vh);
+        auto pixelSize = _pixelSize(format);
+        auto buffer = (uint8_t*)malloc(pixelSize * w * h);
+        if (!buffer) return false;
+        if (stride == w) {
+            memcpy((void*)buffer, data, pixelSize * w * h);
+        } else {
+            for (uint32_t y = 0; y < h; ++y) {
+                memcpy((void*)(buffer + y * w * pixelSize), (const uint8_t*)data + y * stride * pixelSize, pixelSize * w);
+            }
+        }
+        content = (const uint32_t*)buffer;
+        contentStride = w;
+    //Refer the given pixels as they are. (ie, a region of the sprite sheet)
+    } else {
+        content = (const uint32_t*)data;
+        contentStride = stride;
     }
-    else content = data;
 
     return true;
 }
@@ -76,3 +100,15 @@ const uint32_t* RawLoader::pixels()
 {
     return this->content;
 }
+
+
+uint32_t RawLoader::stride()
+{
+    return this->contentStride;
+}
+
+
+Picture::PixelFormat RawLoader::format()
+{
+    return this->contentFormat;
+}
@@ -26,16 +26,20 @@ class RawLoader : public Loader
 {
 public:
     const uint32_t* content = nullptr;
+    uint32_t contentStride = 0;
+    Picture::PixelFormat contentFormat = Picture::Color32;
     bool copy = false;
 
     ~RawLoader();
 
     using Loader::open;
-    bool open(const uint32_t* data, uint32_t w, uint32_t h, bool copy) override;
+    bool open(const void* data, uint32_t w, uint32_t h, uint32_t stride, Picture::PixelFormat format, bool copy) override;
     bool read() override;
     bool close() override;
 
     const uint32_t* pixels() override;
+    uint32_t stride() override;
+    Picture::PixelFormat format() override;
 };
 
 
@@ -22,13 +22,13 @@
 
 #define _USE_MATH_DEFINES       //Math Constants are not defined in Standard C/C++.
 
-#include <fstream>
 #include <float.h>
 #include <math.h>
 #include "tvgLoaderMgr.h"
 #include "tvgXmlParser.h"
 #include "tvgSvgLoader.h"
 #include "tvgSvgSceneBuilder.h"
+#include "tvgSvgPath.h"
 #include "tvgSvgUtil.h"
 
 /************************************************************************/
@@ -463,6 +463,8 @@ static constexpr struct
     { "yellowgreen", 0xff9acd32 }
 };
 
+static constexpr auto colorHash = SVG_PERFECT_HASH(2048, colors, name);
+
 
 static void _toColor(const char* str, uint8_t* r, uint8_t* g, uint8_t* b, string** ref)
 {
@@ -514,13 +516,11 @@ static void _toColor(const char* str, uint8_t* r, uint8_t* g, uint8_t* b, string
         *ref = _idFromUrl((const char*)(str + 3));
     } else {
         //Handle named color
-        for (unsigned int i = 0; i < (sizeof(colors) / sizeof(colors[0])); i++) {
-            if (!strcasecmp(colors[i].name, str)) {
-                *r = (((uint8_t*)(&(colors[i].value)))[2]);
-                *g = (((uint8_t*)(&(colors[i].value)))[1]);
-                *b = (((uint8_t*)(&(colors[i].value)))[0]);
-                return;
-            }
+        auto i = colorHash.find(str, len);
+        if (i >= 0 && !strcasecmp(colors[i].name, str)) {
+            *r = (((uint8_t*)(&(colors[i].value)))[2]);
+            *g = (((uint8_t*)(&(colors[i].value)))[1]);
+            *b = (((uint8_t*)(&(colors[i].value)))[0]);
         }
     }
 }
@@ -942,6 +942,8 @@ static constexpr struct
     STYLE_DEF(display, Display, SvgStyleFlags::Display)
 };
 
+static constexpr auto styleHash = SVG_PERFECT_HASH(64, styleTags, tag);
+
 
 static bool _parseStyleAttr(void* data, const char* key, const char* value, bool style)
 {
@@ -955,16 +957,15 @@ static bool _parseStyleAttr(void* data, const char* key, const char* value, bool
     value = _skipSpace(value, nullptr);
 
     sz = strlen(key);
-    for (unsigned int i = 0; i < sizeof(styleTags) / sizeof(styleTags[0]); i++) {
-        if (styleTags[i].sz - 1 == sz && !strncmp(styleTags[i].tag, key, sz)) {
-            if (style) {
-                styleTags[i].tagHandler(loader, node, value);
-                node->style->flags = (SvgStyleFlags)((int)node->style->flags | (int)styleTags[i].flag);
-            } else if (!((int)node->style->flags & (int)styleTags[i].flag)) {
-                styleTags[i].tagHandler(loader, node, value);
-            }
-            return true;
+    auto i = styleHash.find(key, sz);
+    if (i >= 0 && styleTags[i].sz - 1 == sz && !strncmp(styleTags[i].tag, key, sz)) {
+        if (style) {
+            styleTags[i].tagHandler(loader, node, value);
+            node->style->flags = (SvgStyleFlags)((int)node->style->flags | (int)styleTags[i].flag);
+        } else if (!((int)node->style->flags & (int)styleTags[i].flag)) {
+            styleTags[i].tagHandler(loader, node, value);
         }
+        return true;
     }
 
     return false;
@@ -1044,19 +1045,17 @@ static bool _attrParseMaskNode(void* data, const char* key, const char* value)
 }
 
 
-static SvgNode* _createNode(SvgNode* parent, SvgNodeType type)
+static SvgNode* _createNode(SvgLoaderData* loader, SvgNode* parent, SvgNodeType type)
 {
-    SvgNode* node = (SvgNode*)calloc(1, sizeof(SvgNode));
+    //The nodes and their styles live in the arena until the loader is closed.
+    SvgNode* node = (SvgNode*)loader->arena.alloc(sizeof(SvgNode));
 
     if (!node) return nullptr;
 
     //Default fill property
-    node->style = (SvgStyleProperty*)calloc(1, sizeof(SvgStyleProperty));
+    node->style = (SvgStyleProperty*)loader->arena.alloc(sizeof(SvgStyleProperty));
 
-    if (!node->style) {
-        free(node);
-        return nullptr;
-    }
+    if (!node->style) return nullptr;
 
     //Update the default value of stroke and fill
     //https://www.w3.org/TR/SVGTiny12/painting.html#SpecifyingPaint
@@ -1098,14 +1097,14 @@ static SvgNode* _createNode(SvgNode* parent, SvgNodeType type)
 static SvgNode* _createDefsNode(TVG_UNUSED SvgLoaderData* loader, TVG_UNUSED SvgNode* parent, const char* buf, unsigned bufLength)
 {
     if (loader->def && loader->doc->node.doc.defs) return nullptr;
-    SvgNode* node = _createNode(nullptr, SvgNodeType::Defs);
+    SvgNode* node = _createNode(loader, nullptr, SvgNodeType::Defs);
     return node;
 }
 
 
 static SvgNode* _createGNode(TVG_UNUSED SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::G);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::G);
     if (!loader->svgParse->node) return nullptr;
 
     simpleXmlParseAttributes(buf, bufLength, _attrParseGNode, loader);
@@ -1115,7 +1114,7 @@ static SvgNode* _createGNode(TVG_UNUSED SvgLoaderData* loader, SvgNode* parent,
 
 static SvgNode* _createSvgNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Doc);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Doc);
     if (!loader->svgParse->node) return nullptr;
     SvgDocNode* doc = &(loader->svgParse->node->node.doc);
 
@@ -1140,7 +1139,7 @@ static SvgNode* _createSvgNode(SvgLoaderData* loader, SvgNode* parent, const cha
 
 static SvgNode* _createMaskNode(SvgLoaderData* loader, SvgNode* parent, TVG_UNUSED const char* buf, TVG_UNUSED unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Mask);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Mask);
     if (!loader->svgParse->node) return nullptr;
 
     simpleXmlParseAttributes(buf, bufLength, _attrParseMaskNode, loader);
@@ -1151,7 +1150,7 @@ static SvgNode* _createMaskNode(SvgLoaderData* loader, SvgNode* parent, TVG_UNUS
 
 static SvgNode* _createClipPathNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::ClipPath);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::ClipPath);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1169,8 +1168,7 @@ static bool _attrParsePathNode(void* data, const char* key, const char* value)
     SvgPathNode* path = &(node->node.path);
 
     if (!strcmp(key, "d")) {
-        //Temporary: need to copy
-        path->path = _copyId(value);
+        path->path = loader->arena.copy(value);
     } else if (!strcmp(key, "style")) {
         return simpleXmlParseW3CAttribute(value, _parseStyleAttr, loader);
     } else if (!strcmp(key, "clip-path")) {
@@ -1189,7 +1187,7 @@ static bool _attrParsePathNode(void* data, const char* key, const char* value)
 
 static SvgNode* _createPathNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Path);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Path);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1249,7 +1247,7 @@ static bool _attrParseCircleNode(void* data, const char* key, const char* value)
 
 static SvgNode* _createCircleNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Circle);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Circle);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1309,7 +1307,7 @@ static bool _attrParseEllipseNode(void* data, const char* key, const char* value
 
 static SvgNode* _createEllipseNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Ellipse);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Ellipse);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1387,7 +1385,7 @@ static bool _attrParsePolygonNode(void* data, const char* key, const char* value
 
 static SvgNode* _createPolygonNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Polygon);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Polygon);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1398,7 +1396,7 @@ static SvgNode* _createPolygonNode(SvgLoaderData* loader, SvgNode* parent, const
 
 static SvgNode* _createPolylineNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Polyline);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Polyline);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1468,7 +1466,7 @@ static bool _attrParseRectNode(void* data, const char* key, const char* value)
 
 static SvgNode* _createRectNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Rect);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Rect);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1530,7 +1528,7 @@ static bool _attrParseLineNode(void* data, const char* key, const char* value)
 
 static SvgNode* _createLineNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Line);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Line);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1600,7 +1598,7 @@ static bool _attrParseImageNode(void* data, const char* key, const char* value)
 
 static SvgNode* _createImageNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Image);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Image);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1634,21 +1632,20 @@ static SvgNode* _findChildById(const SvgNode* node, const char* id)
     return nullptr;
 }
 
-static SvgNode* _findNodeById(SvgNode *node, string* id)
+
+static SvgNode* _findDefsChildById(const SvgLoaderData* loader, const SvgNode* defs, const string* id)
 {
-    SvgNode* result = nullptr;
-    if (node->id && !node->id->compare(*id)) return node;
+    if (!defs) return nullptr;
 
-    if (node->child.count > 0) {
-        auto child = node->child.data;
-        for (uint32_t i = 0; i < node->child.count; ++i, ++child) {
-            result = _findNodeById(*child, id);
-            if (result) break;
-        }
-    }
-    return result;
+    auto node = loader->nodeIds.get(id);
+    if (!node) return nullptr;
+    if (node->parent == defs) return node;
+
+    //The id is defined out of the defs as well, look for the defs one.
+    return _findChildById(defs, id->c_str());
 }
 
+
 static void _cloneGradStops(Array<Fill::ColorStop>& dst, const Array<Fill::ColorStop>& src)
 {
     for (uint32_t i = 0; i < src.count; ++i) {
@@ -1696,7 +1693,18 @@ error_grad_alloc:
 }
 
 
-static void _copyAttr(SvgNode* to, const SvgNode* from)
+//The path is parsed once for all the <use> instances of the node.
+static SvgPathData* _sharePath(SvgNode* node)
+{
+    if (!node->node.path.data && node->node.path.path) {
+        node->node.path.data = new SvgPathData;
+        svgPathToTvgPath(node->node.path.path, node->node.path.data->cmds, node->node.path.data->pts);
+    }
+    return node->node.path.data;
+}
+
+
+static void _copyAttr(SvgNode* to, SvgNode* from)
 {
     //Copy matrix attribute
     if (from->transform) {
@@ -1708,6 +1716,9 @@ static void _copyAttr(SvgNode* to, const SvgNode* from)
     if (from->style->fill.paint.url) to->style->fill.paint.url = new string(from->style->fill.paint.url->c_str());
     if (from->style->stroke.paint.url) to->style->stroke.paint.url = new string(from->style->stroke.paint.url->c_str());
     if (from->style->comp.url) to->style->comp.url = new string(from->style->comp.url->c_str());
+    //Each node owns its gradients, they are updated while building the shape.
+    to->style->fill.paint.gradient = _cloneGradient(from->style->fill.paint.gradient);
+    to->style->stroke.paint.gradient = _cloneGradient(from->style->stroke.paint.gradient);
 
     //Copy node attribute
     switch (from->type) {
@@ -1743,7 +1754,8 @@ static void _copyAttr(SvgNode* to, const SvgNode* from)
             break;
         }
         case SvgNodeType::Path: {
-            if (from->node.path.path) to->node.path.path = new string(from->node.path.path->c_str());
+            to->node.path.data = _sharePath(from);
+            to->node.path.shared = true;
             break;
         }
         case SvgNodeType::Polygon: {
@@ -1773,12 +1785,12 @@ static void _copyAttr(SvgNode* to, const SvgNode* from)
 }
 
 
-static void _cloneNode(SvgNode* from, SvgNode* parent)
+static void _cloneNode(SvgLoaderData* loader, SvgNode* from, SvgNode* parent)
 {
     SvgNode* newNode;
     if (!from || !parent) return;
 
-    newNode = _createNode(parent, from->type);
+    newNode = _createNode(loader, parent, from->type);
 
     if (!newNode) return;
 
@@ -1786,7 +1798,7 @@ static void _cloneNode(SvgNode* from, SvgNode* parent)
 
     auto child = from->child.data;
     for (uint32_t i = 0; i < from->child.count; ++i, ++child) {
-        _cloneNode(*child, newNode);
+        _cloneNode(loader, *child, newNode);
     }
 }
 
@@ -1799,12 +1811,13 @@ static void _postponeCloneNode(SvgLoaderData* loader, SvgNode *node, string* id)
 }
 
 
-static void _clonePostponedNodes(Array<SvgNodeIdPair>* cloneNodes) {
+static void _clonePostponedNodes(SvgLoaderData* loader) {
+    auto cloneNodes = &loader->cloneNodes;
     for (uint32_t i = 0; i < cloneNodes->count; ++i) {
         SvgNodeIdPair nodeIdPair = cloneNodes->data[i];
         SvgNode *defs = _getDefsNode(nodeIdPair.node);
-        SvgNode *nodeFrom = _findChildById(defs, nodeIdPair.id->c_str());
-        _cloneNode(nodeFrom, nodeIdPair.node);
+        SvgNode *nodeFrom = _findDefsChildById(loader, defs, nodeIdPair.id);
+        _cloneNode(loader, nodeFrom, nodeIdPair.node);
         delete nodeIdPair.id;
     }
 }
@@ -1819,9 +1832,9 @@ static bool _attrParseUseNode(void* data, const char* key, const char* value)
     if (!strcmp(key, "xlink:href")) {
         id = _idFromHref(value);
         defs = _getDefsNode(node);
-        nodeFrom = _findChildById(defs, id->c_str());
+        nodeFrom = _findDefsChildById(loader, defs, id);
         if (nodeFrom) {
-            _cloneNode(nodeFrom, node);
+            _cloneNode(loader, nodeFrom, node);
             delete id;
         } else {
             //some svg export software include <defs> element at the end of the file
@@ -1842,7 +1855,7 @@ static bool _attrParseUseNode(void* data, const char* key, const char* value)
 
 static SvgNode* _createUseNode(SvgLoaderData* loader, SvgNode* parent, const char* buf, unsigned bufLength)
 {
-    loader->svgParse->node = _createNode(parent, SvgNodeType::Use);
+    loader->svgParse->node = _createNode(loader, parent, SvgNodeType::Use);
 
     if (!loader->svgParse->node) return nullptr;
 
@@ -1883,23 +1896,25 @@ static constexpr struct
 };
 
 
-#define FIND_FACTORY(Short_Name, Tags_Array)                                           \
-    static FactoryMethod                                                               \
-        _find##Short_Name##Factory(const char* name)                                   \
-    {                                                                                  \
-        unsigned int i;                                                                \
-        int sz = strlen(name);                                                         \
-                                                                                       \
-        for (i = 0; i < sizeof(Tags_Array) / sizeof(Tags_Array[0]); i++) {             \
-            if (Tags_Array[i].sz - 1 == sz && !strncmp(Tags_Array[i].tag, name, sz)) { \
-                return Tags_Array[i].tagHandler;                                       \
-            }                                                                          \
-        }                                                                              \
-        return nullptr;                                                                \
+static constexpr auto groupHash = SVG_PERFECT_HASH(16, groupTags, tag);
+static constexpr auto graphicsHash = SVG_PERFECT_HASH(32, graphicsTags, tag);
+
+
+#define FIND_FACTORY(Short_Name, Tags_Array, Tags_Hash)                                      \
+    static FactoryMethod                                                                     \
+        _find##Short_Name##Factory(const char* name)                                         \
+    {                                                                                        \
+        int sz = strlen(name);                                                               \
+        auto i = Tags_Hash.find(name, sz);                                                   \
+                                                                                             \
+        if (i >= 0 && Tags_Array[i].sz - 1 == sz && !strncmp(Tags_Array[i].tag, name, sz)) { \
+            return Tags_Array[i].tagHandler;                                                 \
+        }                                                                                    \
+        return nullptr;                                                                      \
     }
 
-FIND_FACTORY(Group, groupTags)
-FIND_FACTORY(Graphics, graphicsTags)
+FIND_FACTORY(Group, groupTags, groupHash)
+FIND_FACTORY(Graphics, graphicsTags, graphicsHash)
 
 
 FillSpread _parseSpreadValue(const char* value)
@@ -2359,6 +2374,7 @@ static void _svgLoaderParserXmlOpen(SvgLoaderData* loader, const char* content,
         }
 
         if (!node) return;
+        loader->nodeIds.put(node->id, node);
         if (node->type == SvgNodeType::Defs) {
             loader->doc->node.doc.defs = node;
             loader->def = node;
@@ -2370,6 +2386,7 @@ static void _svgLoaderParserXmlOpen(SvgLoaderData* loader, const char* content,
         if (loader->stack.count > 0) parent = loader->stack.data[loader->stack.count - 1];
         else parent = loader->doc;
         node = method(loader, parent, attrs, attrsLength);
+        if (node) loader->nodeIds.put(node->id, node);
     } else if ((gradientMethod = _findGradientFactory(tagName))) {
         SvgStyleGradient* gradient;
         gradient = gradientMethod(loader, attrs, attrsLength);
@@ -2384,6 +2401,7 @@ static void _svgLoaderParserXmlOpen(SvgLoaderData* loader, const char* content,
         } else {
             loader->gradients.push(gradient);
         }
+        loader->gradientIds.put(gradient->id, gradient);
         loader->latestGradient = gradient;
     } else if (!strcmp(tagName, "stop")) {
         if (!loader->latestGradient) {
@@ -2501,7 +2519,7 @@ static void _inefficientNodeCheck(SvgNode* node){
 
     switch (node->type) {
         case SvgNodeType::Path: {
-            if (!node->node.path.path || node->node.path.path->empty()) printf("SVG: Inefficient elements used [Empty path][Node Type : %s]\n", simpleXmlNodeTypeToString(node->type).c_str());
+            if ((!node->node.path.path || !*node->node.path.path) && !node->node.path.data) printf("SVG: Inefficient elements used [Empty path][Node Type : %s]\n", simpleXmlNodeTypeToString(node->type).c_str());
             break;
         }
         case SvgNodeType::Ellipse: {
@@ -2544,39 +2562,23 @@ static void _updateStyle(SvgNode* node, SvgStyleProperty* parentStyle)
 }
 
 
-static SvgStyleGradient* _gradientDup(Array<SvgStyleGradient*>* gradients, const string* id)
+static SvgStyleGradient* _gradientDup(const SvgIdMap<SvgStyleGradient>& gradients, const string* id)
 {
-    SvgStyleGradient* result = nullptr;
-
-    auto gradList = gradients->data;
-
-    for (uint32_t i = 0; i < gradients->count; ++i) {
-        if (!((*gradList)->id->compare(*id))) {
-            result = _cloneGradient(*gradList);
-            break;
-        }
-        ++gradList;
-    }
+    auto result = _cloneGradient(gradients.get(id));
 
     if (result && result->ref) {
-        gradList = gradients->data;
-        for (uint32_t i = 0; i < gradients->count; ++i) {
-            if (!((*gradList)->id->compare(*result->ref))) {
-                if (result->stops.count == 0) {
-                    _cloneGradStops(result->stops, (*gradList)->stops);
-                }
-                //TODO: Properly inherit other property
-                break;
-            }
-            ++gradList;
+        auto ref = gradients.get(result->ref);
+        if (ref && result->stops.count == 0) {
+            _cloneGradStops(result->stops, ref->stops);
         }
+        //TODO: Properly inherit other property
     }
 
     return result;
 }
 
 
-static void _updateGradient(SvgNode* node, Array<SvgStyleGradient*>* gradients)
+static void _updateGradient(SvgNode* node, const SvgIdMap<SvgStyleGradient>& gradients)
 {
     if (node->child.count > 0) {
         auto child = node->child.data;
@@ -2596,16 +2598,16 @@ static void _updateGradient(SvgNode* node, Array<SvgStyleGradient*>* gradients)
 }
 
 
-static void _updateComposite(SvgNode* node, SvgNode* root)
+static void _updateComposite(SvgNode* node, const SvgIdMap<SvgNode>& nodes)
 {
     if (node->style->comp.url && !node->style->comp.node) {
-        SvgNode *findResult = _findNodeById(root, node->style->comp.url);
+        SvgNode *findResult = nodes.get(node->style->comp.url);
         if (findResult) node->style->comp.node = findResult;
     }
     if (node->child.count > 0) {
         auto child = node->child.data;
         for (uint32_t i = 0; i < node->child.count; ++i, ++child) {
-            _updateComposite(*child, root);
+            _updateComposite(*child, nodes);
         }
     }
 }
@@ -2623,7 +2625,6 @@ static void _freeNodeStyle(SvgStyleProperty* style)
     delete(style->fill.paint.url);
     delete(style->stroke.paint.url);
     style->stroke.dash.array.reset();
-    free(style);
 }
 
 
@@ -2642,7 +2643,7 @@ static void _freeNode(SvgNode* node)
     _freeNodeStyle(node->style);
     switch (node->type) {
          case SvgNodeType::Path: {
-             delete node->node.path.path;
+             if (!node->node.path.shared) delete(node->node.path.data);
              break;
          }
          case SvgNodeType::Polygon: {
@@ -2674,7 +2675,6 @@ static void _freeNode(SvgNode* node)
              break;
          }
     }
-    free(node);
 }
 
 
@@ -2738,12 +2738,52 @@ static bool _svgLoaderParserForValidCheck(void* data, SimpleXMLType type, const
 }
 
 
+static bool _prepareParser(SvgLoaderData* loader)
+{
+    if (!loader->svgParse) {
+        loader->svgParse = (SvgParser*)malloc(sizeof(SvgParser));
+        if (!loader->svgParse) return false;
+    }
+    loader->svgParse->flags = SvgStopStyleFlags::StopDefault;
+    return true;
+}
+
+
 void SvgLoader::clear()
 {
     if (copy) free((char*)content);
+    file.close();
     size = 0;
+    reserved = 0;
     content = nullptr;
     copy = false;
+    feeding = false;
+}
+
+
+bool SvgLoader::viewbox()
+{
+    if (!loaderData.doc || loaderData.doc->type != SvgNodeType::Doc) return false;
+
+    //Return the brief resource info such as viewbox:
+    vx = loaderData.doc->node.doc.vx;
+    vy = loaderData.doc->node.doc.vy;
+    w = vw = loaderData.doc->node.doc.vw;
+    h = vh = loaderData.doc->node.doc.vh;
+
+    //Override size
+    if (loaderData.doc->node.doc.w > 0) {
+        w = loaderData.doc->node.doc.w;
+        if (vw < FLT_EPSILON) vw = w;
+    }
+    if (loaderData.doc->node.doc.h > 0) {
+        h = loaderData.doc->node.doc.h;
+        if (vh < FLT_EPSILON) vh = h;
+    }
+
+    preserveAspect = loaderData.doc->node.doc.preserveAspect;
+
+    return true;
 }
 
 
@@ -2762,23 +2802,25 @@ SvgLoader::~SvgLoader()
 }
 
 
+void SvgLoader::wait()
+{
+    this->done();
+}
+
+
 void SvgLoader::run(unsigned tid)
 {
     if (!simpleXmlParse(content, size, true, _svgLoaderParser, &(loaderData))) return;
 
     if (loaderData.doc) {
         _updateStyle(loaderData.doc, nullptr);
-        auto defs = loaderData.doc->node.doc.defs;
-        if (defs) _updateGradient(loaderData.doc, &defs->node.defs.gradients);
-
-        if (loaderData.gradients.count > 0) _updateGradient(loaderData.doc, &loaderData.gradients);
+        if (loaderData.gradientIds.count > 0) _updateGradient(loaderData.doc, loaderData.gradientIds);
 
-        _updateComposite(loaderData.doc, loaderData.doc);
-        if (defs) _updateComposite(loaderData.doc, defs);
+        _updateComposite(loaderData.doc, loaderData.nodeIds);
 
-        if (loaderData.cloneNodes.count > 0) _clonePostponedNodes(&loaderData.cloneNodes);
+        if (loaderData.cloneNodes.count > 0) _clonePostponedNodes(&loaderData);
     }
-    root = svgSceneBuild(loaderData.doc, vx, vy, vw, vh);
+    root = svgSceneBuild(loaderData.doc, vx, vy, vw, vh, &builder);
 };
 
 
@@ -2787,37 +2829,12 @@ bool SvgLoader::header()
     //For valid check, only <svg> tag is parsed first.
     //If the <svg> tag is found, the loaded file is valid and stores viewbox information.
     //After that, the remaining content data is parsed in order with async.
-    loaderData.svgParse = (SvgParser*)malloc(sizeof(SvgParser));
-    if (!loaderData.svgParse) return false;
-
-    loaderData.svgParse->flags = SvgStopStyleFlags::StopDefault;
+    if (!_prepareParser(&loaderData)) return false;
 
     simpleXmlParse(content, size, true, _svgLoaderParserForValidCheck, &(loaderData));
 
-    if (loaderData.doc && loaderData.doc->type == SvgNodeType::Doc) {
-        //Return the brief resource info such as viewbox:
-        vx = loaderData.doc->node.doc.vx;
-        vy = loaderData.doc->node.doc.vy;
-        w = vw = loaderData.doc->node.doc.vw;
-        h = vh = loaderData.doc->node.doc.vh;
-
-        //Override size
-        if (loaderData.doc->node.doc.w > 0) {
-            w = loaderData.doc->node.doc.w;
-            if (vw < FLT_EPSILON) vw = w;
-        }
-        if (loaderData.doc->node.doc.h > 0) {
-            h = loaderData.doc->node.doc.h;
-            if (vh < FLT_EPSILON) vh = h;
-        }
-
-        preserveAspect = loaderData.doc->node.doc.preserveAspect;
-    } else {
-        //LOG: No SVG File. There is no <svg/>
-        return false;
-    }
-
-    return true;
+    //LOG: No SVG File. There is no <svg/>
+    return viewbox();
 }
 
 
@@ -2842,26 +2859,58 @@ bool SvgLoader::open(const string& path)
 {
     clear();
 
-    ifstream f;
-    f.open(path);
+    //Parse over the file pages directly.
+    if (!file.open(path)) return false;
 
-    if (!f.is_open()) return false;
+    content = file.data;
+    size = file.size;
 
-    getline(f, filePath, '\0');
-    f.close();
+    return header();
+}
 
-    if (filePath.empty()) return false;
 
-    content = filePath.c_str();
-    size = filePath.size();
+bool SvgLoader::feed(const char* data, uint32_t size)
+{
+    if (!feeding) {
+        clear();
+        if (!_prepareParser(&loaderData)) return false;
+        feeding = true;
+        copy = true;
+    }
 
-    return header();
+    //Join the chunk to the tail left by the previous one.
+    if (this->size + size > reserved) {
+        auto buffer = (char*)realloc((char*)content, (this->size + size) * 2);
+        if (!buffer) return false;
+        content = buffer;
+        reserved = (this->size + size) * 2;
+    }
+    memcpy((char*)content + this->size, data, size);
+    this->size += size;
+
+    //Nothing can be completed without a tag boundary, don't rescan the long tags over again.
+    if (!memchr(data, '>', size) && !memchr(data, '<', size)) return true;
+
+    //The nodes are built as soon as their tags are complete, the cut off tag waits for the next chunk.
+    unsigned parsed;
+    if (!simpleXmlParseChunk(content, this->size, true, _svgLoaderParser, &(loaderData), &parsed)) return false;
+    this->size -= parsed;
+    memmove((char*)content, content + parsed, this->size);
+
+    //The viewbox is known once the <svg> tag arrived.
+    viewbox();
+
+    return true;
 }
 
 
 bool SvgLoader::read()
 {
-    if (!content || size == 0) return false;
+    //The rest of the fed content is parsed with the scene.
+    if (feeding) {
+        feeding = false;
+        if (!loaderData.doc) return false;
+    } else if (!content || size == 0) return false;
 
     TaskScheduler::request(this);
 
@@ -2873,6 +2922,9 @@ bool SvgLoader::close()
 {
     this->done();
 
+    svgShapeBuilderFree(builder);
+    builder = nullptr;
+
     if (loaderData.svgParse) {
         free(loaderData.svgParse);
         loaderData.svgParse = nullptr;
@@ -2883,9 +2935,12 @@ bool SvgLoader::close()
         ++gradients;
     }
     loaderData.gradients.reset();
+    loaderData.gradientIds.reset();
+    loaderData.nodeIds.reset();
 
     _freeNode(loaderData.doc);
     loaderData.doc = nullptr;
+    loaderData.arena.reset();
     loaderData.stack.reset();
 
     clear();
@@ -2897,6 +2952,8 @@ bool SvgLoader::close()
 unique_ptr<Scene> SvgLoader::scene()
 {
     this->done();
-    if (root) return move(root);
-    else return nullptr;
+    if (!root) return nullptr;
+    //The scene is kept for the other pictures sharing this loader.
+    if (cached) return unique_ptr<Scene>(static_cast<Scene*>(root->duplicate()));
+    return move(root);
 }
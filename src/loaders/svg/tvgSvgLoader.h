@@ -23,17 +23,22 @@
 #define _TVG_SVG_LOADER_H_
 
 #include "tvgTaskScheduler.h"
+#include "tvgFileSource.h"
 #include "tvgSvgLoaderCommon.h"
 
+struct SvgShapeBuilder;
+
 class SvgLoader : public Loader, public Task
 {
 public:
-    string filePath;
+    FileSource file;
     const char* content = nullptr;
     uint32_t size = 0;
+    uint32_t reserved = 0;      //capacity of the content collected by feed()
 
     SvgLoaderData loaderData;
     unique_ptr<Scene> root;
+    SvgShapeBuilder* builder = nullptr;
 
     bool copy = false;
 
@@ -45,14 +50,17 @@ public:
     bool open(const char* data, uint32_t size, bool copy) override;
 
     bool header();
+    bool feed(const char* data, uint32_t size) override;
     bool read() override;
     bool close() override;
+    void wait() override;
     void run(unsigned tid) override;
 
     unique_ptr<Scene> scene() override;
 
 private:
     void clear();
+    bool viewbox();
 };
 
 
@@ -195,9 +195,18 @@ struct SvgImageNode
     string *href;
 };
 
+//Parsed path data, shared by the node and its <use> instances
+struct SvgPathData
+{
+    Array<PathCommand> cmds;
+    Array<Point> pts;
+};
+
 struct SvgPathNode
 {
-    string* path;
+    const char* path;       //allocated from the arena
+    SvgPathData* data;
+    bool shared;            //the data is owned by the origin node
 };
 
 struct SvgPolygonNode
@@ -357,6 +366,152 @@ struct SvgNodeIdPair
     string *id;
 };
 
+//Open addressing table of the document ids, the keys are owned by the nodes and the gradients.
+template<class T>
+struct SvgIdMap
+{
+    struct Slot
+    {
+        const string* key;
+        T* value;
+    };
+
+    Slot* slots = nullptr;
+    uint32_t count = 0;
+    uint32_t size = 0;          //power of 2
+
+    static uint32_t hash(const string* key)
+    {
+        //FNV-1a
+        uint32_t h = 2166136261u;
+        for (auto c : *key) h = (h ^ (uint8_t)c) * 16777619u;
+        return h;
+    }
+
+    bool grow()
+    {
+        auto old = slots;
+        auto oldSize = size;
+
+        size = size ? size * 2 : 64;
+        slots = (Slot*)calloc(size, sizeof(Slot));
+        if (!slots) {
+            slots = old;
+            size = oldSize;
+            return false;
+        }
+        count = 0;
+        for (uint32_t i = 0; i < oldSize; ++i) {
+            if (old[i].key) put(old[i].key, old[i].value);
+        }
+        free(old);
+        return true;
+    }
+
+    //The first definition of an id wins, same as the document order lookup.
+    void put(const string* key, T* value)
+    {
+        if (!key || !value) return;
+        if ((count + 1) * 2 > size && !grow()) return;
+
+        auto i = hash(key) & (size - 1);
+        while (slots[i].key) {
+            if (*slots[i].key == *key) return;
+            i = (i + 1) & (size - 1);
+        }
+        slots[i] = {key, value};
+        ++count;
+    }
+
+    T* get(const string* key) const
+    {
+        if (!key || count == 0) return nullptr;
+
+        auto i = hash(key) & (size - 1);
+        while (slots[i].key) {
+            if (*slots[i].key == *key) return slots[i].value;
+            i = (i + 1) & (size - 1);
+        }
+        return nullptr;
+    }
+
+    void reset()
+    {
+        free(slots);
+        slots = nullptr;
+        count = size = 0;
+    }
+
+    ~SvgIdMap()
+    {
+        free(slots);
+    }
+};
+
+//Bump allocator of the document nodes, all of them are released at once.
+struct SvgArena
+{
+    struct Block
+    {
+        Block* next;
+        size_t size;
+        size_t used;
+    };
+
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+    static constexpr size_t HEADER_SIZE = (sizeof(Block) + 15) & ~size_t(15);
+
+    Block* head = nullptr;
+
+    //Returns zero initialized memory.
+    void* alloc(size_t size)
+    {
+        size = (size + 15) & ~size_t(15);
+
+        if (!head || head->used + size > head->size) {
+            auto cap = size > BLOCK_SIZE ? size : BLOCK_SIZE;
+            auto block = (Block*)calloc(1, HEADER_SIZE + cap);
+            if (!block) return nullptr;
+            block->size = cap;
+            //Keep filling the current block if the new one is used up by a large request.
+            if (head && cap - size < head->size - head->used) {
+                block->next = head->next;
+                head->next = block;
+                block->used = size;
+                return (char*)block + HEADER_SIZE;
+            }
+            block->next = head;
+            head = block;
+        }
+
+        auto ptr = (char*)head + HEADER_SIZE + head->used;
+        head->used += size;
+        return ptr;
+    }
+
+    const char* copy(const char* str)
+    {
+        auto len = strlen(str) + 1;
+        auto ptr = (char*)alloc(len);
+        if (ptr) memcpy(ptr, str, len);
+        return ptr;
+    }
+
+    void reset()
+    {
+        while (head) {
+            auto next = head->next;
+            free(head);
+            head = next;
+        }
+    }
+
+    ~SvgArena()
+    {
+        reset();
+    }
+};
+
 struct SvgLoaderData
 {
     Array<SvgNode *> stack = {nullptr, 0, 0};
@@ -366,6 +521,9 @@ struct SvgLoaderData
     SvgStyleGradient* latestGradient = nullptr; //For stops
     SvgParser* svgParse = nullptr;
     Array<SvgNodeIdPair> cloneNodes;
+    SvgIdMap<SvgNode> nodeIds;
+    SvgIdMap<SvgStyleGradient> gradientIds;
+    SvgArena arena;
     int level = 0;
     bool result = false;
 };
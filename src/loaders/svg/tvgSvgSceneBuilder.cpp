@@ -21,6 +21,8 @@
  */
 #include <math.h>
 #include <string>
+#include <atomic>
+#include "tvgTaskScheduler.h"
 #include "tvgSvgLoaderCommon.h"
 #include "tvgSvgSceneBuilder.h"
 #include "tvgSvgPath.h"
@@ -297,8 +299,12 @@ static bool _appendShape(SvgNode* node, Shape* shape, float vx, float vy, float
 
     switch (node->type) {
         case SvgNodeType::Path: {
-            if (node->node.path.path) {
-                if (svgPathToTvgPath(node->node.path.path->c_str(), cmds, pts)) {
+            //The <use> instances share the path of their origin node
+            if (node->node.path.data) {
+                auto data = node->node.path.data;
+                shape->appendPath(data->cmds.data, data->cmds.count, data->pts.data, data->pts.count);
+            } else if (node->node.path.path) {
+                if (svgPathToTvgPath(node->node.path.path, cmds, pts)) {
                     shape->appendPath(cmds.data, cmds.count, pts.data, pts.count);
                 }
             }
@@ -428,8 +434,12 @@ static unique_ptr<Picture> _imageBuildHelper(SvgNode* node, float vx, float vy,
         imageMimeTypeEncoding encoding;
         if (!_isValidImageMimeTypeAndEncoding(&href, &encoding)) return nullptr; //not allowed mime type or encoding
         if (encoding == imageMimeTypeEncoding::base64) {
-            string decoded = svgUtilBase64Decode(href);
-            if (picture->load(decoded.c_str(), decoded.size(), true) != Result::Success) return nullptr;
+            //Loaders keep their own copy only if they need the data after loading.
+            char* decoded;
+            auto size = svgUtilBase64Decode(href, &decoded);
+            auto result = picture->load(decoded, size, true);
+            free(decoded);
+            if (result != Result::Success) return nullptr;
         } else {
             string decoded = svgUtilURLDecode(href);
             if (picture->load(decoded.c_str(), decoded.size(), true) != Result::Success) return nullptr;
@@ -465,7 +475,187 @@ static unique_ptr<Picture> _imageBuildHelper(SvgNode* node, float vx, float vy,
 }
 
 
-static unique_ptr<Scene> _sceneBuildHelper(const SvgNode* node, float vx, float vy, float vw, float vh)
+//Number of the leaf shapes built by a task at once
+#define SHAPE_BATCH 64
+
+struct SvgShapeTask : Task
+{
+    SvgShapeBuilder* builder;
+    void run(unsigned tid) override;
+};
+
+
+struct SvgShapeBuilder
+{
+    Array<SvgNode*> nodes;          //leaf nodes in the order of the scene tree walk
+    Array<Shape*> shapes;           //built shapes, nullptr if invalid
+    Array<SvgNode*> images;         //image nodes in the order of the scene tree walk
+    Array<Picture*> pictures;       //loaded images, nullptr if invalid
+    Array<SvgShapeTask*> tasks;
+    float vx, vy, vw, vh;
+    uint32_t batches;
+    uint32_t jobs;                  //an image or a batch of shapes each
+    uint32_t cur = 0;               //the walk position in nodes
+    uint32_t curImage = 0;          //the walk position in images
+    atomic<uint32_t> next{0};
+    atomic<uint32_t> finished{0};
+    mutex mtx;
+    condition_variable cv;
+
+    ~SvgShapeBuilder()
+    {
+        //The tasks may still be queued, even though there is nothing left for them.
+        for (uint32_t i = 0; i < tasks.count; ++i) {
+            tasks.data[i]->done();
+            delete(tasks.data[i]);
+        }
+        for (uint32_t i = cur; i < shapes.count; ++i) delete(shapes.data[i]);
+        for (uint32_t i = curImage; i < pictures.count; ++i) delete(pictures.data[i]);
+    }
+
+    bool process()
+    {
+        auto job = next++;
+        if (job >= jobs) return false;
+
+        //The images take the longest, they go first.
+        if (job < images.count) {
+            pictures.data[job] = _imageBuildHelper(images.data[job], vx, vy, vw, vh).release();
+        } else {
+            auto batch = job - images.count;
+            auto end = (batch + 1) * SHAPE_BATCH;
+            if (end > nodes.count) end = nodes.count;
+
+            for (auto i = batch * SHAPE_BATCH; i < end; ++i) {
+                shapes.data[i] = _shapeBuildHelper(nodes.data[i], vx, vy, vw, vh).release();
+            }
+        }
+
+        if (++finished == jobs) {
+            lock_guard<mutex> lock(mtx);
+            cv.notify_one();
+        }
+        return true;
+    }
+
+    void build()
+    {
+        shapes.reserve(nodes.count);
+        shapes.count = nodes.count;
+        pictures.reserve(images.count);
+        pictures.count = images.count;
+        batches = (nodes.count + SHAPE_BATCH - 1) / SHAPE_BATCH;
+        jobs = images.count + batches;
+
+        //The calling thread is a worker as well, it takes the jobs the others don't reach.
+        auto cnt = TaskScheduler::threads() - 1;
+        if (cnt > jobs - 1) cnt = jobs - 1;
+        tasks.reserve(cnt);
+        for (uint32_t i = 0; i < cnt; ++i) {
+            auto task = new SvgShapeTask;
+            task->builder = this;
+            tasks.push(task);
+            TaskScheduler::request(task);
+        }
+
+        while (process());
+
+        //Never wait for the queued tasks, but for the jobs in progress.
+        unique_lock<mutex> lock(mtx);
+        while (finished < jobs) cv.wait(lock);
+    }
+
+    bool prebuilt(const SvgNode* node)
+    {
+        if (node->type == SvgNodeType::Image) return (curImage < images.count && images.data[curImage] == node);
+        return (cur < nodes.count && nodes.data[cur] == node);
+    }
+
+    unique_ptr<Shape> take()
+    {
+        return unique_ptr<Shape>(shapes.data[cur++]);
+    }
+
+    unique_ptr<Picture> takeImage()
+    {
+        return unique_ptr<Picture>(pictures.data[curImage++]);
+    }
+};
+
+
+void SvgShapeTask::run(unsigned tid)
+{
+    while (builder->process());
+}
+
+
+static bool _composed(const SvgNode* node, const Array<const SvgNode*>& comps)
+{
+    if (node->type == SvgNodeType::ClipPath) return true;
+    for (uint32_t i = 0; i < comps.count; ++i) {
+        if (comps.data[i] == node) return true;
+    }
+    return false;
+}
+
+
+static void _collectComps(const SvgNode* node, Array<const SvgNode*>& comps)
+{
+    if (node->style->comp.node) comps.push(node->style->comp.node);
+
+    auto child = node->child.data;
+    for (uint32_t i = 0; i < node->child.count; ++i, ++child) {
+        _collectComps(*child, comps);
+    }
+}
+
+
+//Follows the scene tree walk, but skips the nodes which take part in any composition
+//since building those shares the composition nodes.
+static void _collectShapes(const SvgNode* node, const Array<const SvgNode*>& comps, SvgShapeBuilder* builder)
+{
+    if (_composed(node, comps)) return;
+    if (!node->display || node->style->opacity == 0) return;
+
+    auto child = node->child.data;
+    for (uint32_t i = 0; i < node->child.count; ++i, ++child) {
+        if (_isGroupType((*child)->type)) {
+            _collectShapes(*child, comps, builder);
+        } else if ((*child)->style->comp.method == CompositeMethod::None) {
+            if ((*child)->type == SvgNodeType::Image) builder->images.push(*child);
+            else builder->nodes.push(*child);
+        }
+    }
+}
+
+
+static SvgShapeBuilder* _prebuildShapes(const SvgNode* node, float vx, float vy, float vw, float vh)
+{
+    if (TaskScheduler::threads() < 2) return nullptr;
+
+    auto builder = new SvgShapeBuilder;
+
+    Array<const SvgNode*> comps;
+    _collectComps(node, comps);
+    _collectShapes(node, comps, builder);
+
+    //Not worth it
+    if (builder->images.count == 0 && builder->nodes.count <= SHAPE_BATCH) {
+        delete(builder);
+        return nullptr;
+    }
+
+    builder->vx = vx;
+    builder->vy = vy;
+    builder->vw = vw;
+    builder->vh = vh;
+    builder->build();
+
+    return builder;
+}
+
+
+static unique_ptr<Scene> _sceneBuildHelper(const SvgNode* node, float vx, float vy, float vw, float vh, SvgShapeBuilder* builder)
 {
     if (_isGroupType(node->type)) {
         auto scene = Scene::gen();
@@ -475,12 +665,16 @@ static unique_ptr<Scene> _sceneBuildHelper(const SvgNode* node, float vx, float
             auto child = node->child.data;
             for (uint32_t i = 0; i < node->child.count; ++i, ++child) {
                 if (_isGroupType((*child)->type)) {
-                    scene->push(_sceneBuildHelper(*child, vx, vy, vw, vh));
+                    scene->push(_sceneBuildHelper(*child, vx, vy, vw, vh, builder));
                 } else if ((*child)->type == SvgNodeType::Image) {
-                    auto image = _imageBuildHelper(*child, vx, vy, vw, vh);
+                    unique_ptr<Picture> image;
+                    if (builder && builder->prebuilt(*child)) image = builder->takeImage();
+                    else image = _imageBuildHelper(*child, vx, vy, vw, vh);
                     if (image) scene->push(move(image));
                 } else {
-                    auto shape = _shapeBuildHelper(*child, vx, vy, vw, vh);
+                    unique_ptr<Shape> shape;
+                    if (builder && builder->prebuilt(*child)) shape = builder->take();
+                    else shape = _shapeBuildHelper(*child, vx, vy, vw, vh);
                     if (shape) scene->push(move(shape));
                 }
             }
@@ -497,11 +691,14 @@ static unique_ptr<Scene> _sceneBuildHelper(const SvgNode* node, float vx, float
 /* External Class Implementation                                        */
 /************************************************************************/
 
-unique_ptr<Scene> svgSceneBuild(SvgNode* node, float vx, float vy, float vw, float vh)
+unique_ptr<Scene> svgSceneBuild(SvgNode* node, float vx, float vy, float vw, float vh, SvgShapeBuilder** builder)
 {
     if (!node || (node->type != SvgNodeType::Doc)) return nullptr;
 
-    auto docNode = _sceneBuildHelper(node, vx, vy, vw, vh);
+    //The leaf shapes and images are independent, build them in parallel then merge them in the tree order.
+    *builder = _prebuildShapes(node, vx, vy, vw, vh);
+
+    auto docNode = _sceneBuildHelper(node, vx, vy, vw, vh, *builder);
 
     auto viewBoxClip = Shape::gen();
     viewBoxClip->appendRect(vx, vy ,vw, vh, 0, 0);
@@ -516,3 +713,9 @@ unique_ptr<Scene> svgSceneBuild(SvgNode* node, float vx, float vy, float vw, flo
 
     return root;
 }
+
+
+void svgShapeBuilderFree(SvgShapeBuilder* builder)
+{
+    delete(builder);
+}
@@ -25,6 +25,9 @@
 
 #include "tvgCommon.h"
 
-unique_ptr<Scene> svgSceneBuild(SvgNode* node, float vx, float vy, float vw, float vh);
+struct SvgShapeBuilder;
+
+unique_ptr<Scene> svgSceneBuild(SvgNode* node, float vx, float vy, float vw, float vh, SvgShapeBuilder** builder);
+void svgShapeBuilderFree(SvgShapeBuilder* builder);
 
 #endif //_TVG_SVG_SCENE_BUILDER_H_
@@ -23,18 +23,68 @@
 #include <math.h>
 #include <memory.h>
 #include <ctype.h>
-#include <errno.h>
 #include "tvgSvgUtil.h"
 
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+    #include <immintrin.h>
+#endif
+
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-static inline bool _floatExact(float a, float b)
+//Exact powers of 10 in double
+static constexpr double pow10s[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+//Exact powers of 10 in float
+static constexpr float pow10f[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+
+static inline bool _isDigit(char c)
+{
+    return (c >= '0' && c <= '9');
+}
+
+
+static inline bool _isSpace(char c)
 {
-    return memcmp(&a, &b, sizeof (float)) == 0;
+    return (c == ' ' || (c >= '\t' && c <= '\r'));
+}
+
+
+//Up to 19 significant digits, the rest only scale the mantissa.
+static uint64_t _mantissa(const char* iter, int* exponent)
+{
+    uint64_t mantissa = 0;
+    auto significants = 0;
+    auto scale = 0;
+
+    for (; _isDigit(*iter); ++iter) {
+        if (significants < 19) {
+            mantissa = mantissa * 10 + (*iter - '0');
+            if (mantissa > 0) ++significants;
+        } else ++scale;
+    }
+    if (*iter == '.') {
+        for (++iter; _isDigit(*iter); ++iter) {
+            if (significants < 19) {
+                mantissa = mantissa * 10 + (*iter - '0');
+                if (mantissa > 0) ++significants;
+                --scale;
+            }
+        }
+    }
+    *exponent = scale;
+    return mantissa;
 }
 
+
 static uint8_t _hexCharToDec(const char c)
 {
     if (c >= 'a') return c - 'a' + 10;
@@ -52,6 +102,40 @@ static uint8_t _base64Value(const char chr)
 }
 
 
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+/* Decodes 16 characters into 12 bytes, 16 bytes are written.
+   The characters are classified by their nibbles, a block out of the standard alphabet
+   (line breaks, paddings, url safe letters) is left for the scalar decoder. */
+static bool _base64Block(const char* src, char* dst)
+{
+    const auto lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const auto lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const auto lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const auto nibble = _mm_set1_epi8(0x0f);
+
+    auto in = _mm_loadu_si128((__m128i*)src);
+    auto hi = _mm_and_si128(_mm_srli_epi32(in, 4), nibble);
+    auto lo = _mm_and_si128(in, nibble);
+
+    //Invalid if the low nibble is not allowed in the class of the high nibble.
+    auto invalid = _mm_and_si128(_mm_shuffle_epi8(lutLo, lo), _mm_shuffle_epi8(lutHi, hi));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xffff) return false;
+
+    //'/' shares the high nibble with '+', it takes the roll before.
+    auto roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8('/')), hi));
+    auto values = _mm_add_epi8(in, roll);
+
+    //Pack the 6-bit values of every 4 characters into 3 bytes.
+    auto merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    auto packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    packed = _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storeu_si128((__m128i*)dst, packed);
+
+    return true;
+}
+#endif
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -63,200 +147,92 @@ static uint8_t _base64Value(const char chr)
  * src should be one of the following form :
  *
  * [whitespace] [sign] {digits [radix digits] | radix digits} [{e | E} [sign] digits]
- * [whitespace] [sign] {INF | INFINITY}
- * [whitespace] [sign] NAN [sequence]
  *
  * No hexadecimal form supported
- * no sequence supported after NAN
+ * No INF, INFINITY and NAN supported, they are not the numbers of svg
  */
 float svgUtilStrtof(const char *nPtr, char **endPtr)
 {
-    const char *iter;
-    const char *a;
-    float val;
-    unsigned long long integerPart;
-    int minus;
-
     if (endPtr) *endPtr = (char*)nPtr;
     if (!nPtr) return 0.0f;
 
-    a = iter = nPtr;
+    auto iter = nPtr;
 
     //ignore leading whitespaces
-    while (isspace(*iter)) iter++;
+    while (_isSpace(*iter)) iter++;
 
     //signed or not
-    minus = 1;
-    if (*iter == '-')
-    {
-        minus = -1;
+    auto minus = false;
+    if (*iter == '-') {
+        minus = true;
         iter++;
-    }
-    else if (*iter == '+') iter++;
+    } else if (*iter == '+') iter++;
 
-    if (tolower(*iter) == 'i')
-    {
-        if ((tolower(*(iter + 1)) == 'n') && (tolower(*(iter + 2)) == 'f'))
-        {
-            iter += 3;
-        }
-        else goto on_error;
-
-        if (tolower(*(iter + 3)) == 'i')
-        {
-            if ((tolower(*(iter + 4)) == 'n') &&
-                (tolower(*(iter + 5)) == 'i') &&
-                (tolower(*(iter + 6)) == 't') &&
-                (tolower(*(iter + 7)) == 'y'))
-            {
-               iter += 5;
-            }
-            else goto on_error;
-         }
-         if (endPtr) *endPtr = (char *)iter;
-         return (minus == -1) ? -INFINITY : INFINITY;
-    }
-
-    if (tolower(*iter) == 'n')
-    {
-         if ((tolower(*(iter + 1)) == 'a') && (tolower(*(iter + 2)) == 'n')) iter += 3;
-         else goto on_error;
-
-         if (endPtr) *endPtr = (char *)iter;
-         return (minus == -1) ? -NAN : NAN;
-    }
-
-    integerPart = 0;
+    //Digits, the common case
+    uint64_t mantissa = 0;
+    auto exponent = 0;
+    auto begin = iter;
 
     //(optional) integer part before dot
-    if (isdigit(*iter))
-    {
-        for (; isdigit(*iter); iter++) integerPart = integerPart * 10ULL + (unsigned long long)(*iter - '0');
-
-        a = iter;
-    }
-    else if (*iter != '.')
-    {
-        val = 0.0;
-        goto on_success;
-    }
-
-    val = (float)integerPart;
+    while (_isDigit(*iter)) mantissa = mantissa * 10 + (*iter++ - '0');
+    auto digits = iter - begin;
 
     //(optional) decimal part after dot
-    if (*iter == '.')
-    {
-        unsigned long long decimalPart;
-        unsigned long long pow10;
-        int count;
-
-        iter++;
-
-        decimalPart = 0;
-        count = 0;
-        pow10 = 1;
-
-        if (isdigit(*iter))
-        {
-            for (; isdigit(*iter); iter++, count++)
-            {
-                if (count < 19)
-                {
-                    decimalPart = decimalPart * 10ULL +  + (unsigned long long)(*iter - '0');
-                    pow10 *= 10ULL;
-                }
-            }
-        }
-        val += (float)decimalPart / (float)pow10;
-        a = iter;
+    if (*iter == '.') {
+        auto fraction = ++iter;
+        while (_isDigit(*iter)) mantissa = mantissa * 10 + (*iter++ - '0');
+        exponent = -int(iter - fraction);
+        digits += iter - fraction;
     }
 
-    //(optional) exponent
-    if ((*iter == 'e') || (*iter == 'E'))
-    {
-        float scale = 1.0f;
-        unsigned int expo_part;
-        int minus_e;
+    //No digits, nothing is read.
+    if (digits == 0) return 0.0f;
 
-        ++iter;
+    //The mantissa may have overflowed, take the 19 significant digits over again.
+    if (digits > 19) mantissa = _mantissa(begin, &exponent);
 
+    //(optional) exponent, only when it has digits
+    if ((*iter == 'e') || (*iter == 'E')) {
+        auto e = iter + 1;
         //Exception: svg may have 'em' unit for fonts. ex) 5em, 10.5em
-        if ((*iter == 'm') || (*iter == 'M')) {
+        if ((*e == 'm') || (*e == 'M')) {
             //TODO: We don't support font em unit now, but has to multiply val * font size later...
-            a = iter + 1;
-            goto on_success;
-        }
-
-        //signed or not
-        minus_e = 1;
-        if (*iter == '-')
-        {
-            minus_e = -1;
-            ++iter;
-        }
-        else if (*iter == '+') iter++;
-
-        //exponential part
-        expo_part = 0;
-        if (isdigit(*iter))
-        {
-            while (*iter == 0) iter++;
-
-            for (; isdigit(*iter); iter++)
-            {
-                expo_part = expo_part * 10U + (unsigned int)(*iter - '0');
+            iter = e + 1;
+        } else {
+            auto minusE = false;
+            if (*e == '-') {
+                minusE = true;
+                ++e;
+            } else if (*e == '+') ++e;
+
+            if (_isDigit(*e)) {
+                auto expo = 0;
+                for (; _isDigit(*e); ++e) {
+                    if (expo < 100000) expo = expo * 10 + (*e - '0');
+                }
+                exponent += minusE ? -expo : expo;
+                iter = e;
             }
         }
-        else if (!isdigit(*(a - 1)))
-        {
-            a = nPtr;
-            goto on_success;
-        }
-        else if (*iter == 0) goto on_success;
-
-        if ((_floatExact(val, 2.2250738585072011)) && ((minus_e * (int)expo_part) == -308))
-        {
-            val *= 1.0e-308;
-            a = iter;
-            errno = ERANGE;
-            goto on_success;
-        }
-
-        if ((_floatExact(val, 2.2250738585072012)) && ((minus_e * (int)expo_part) <= -308))
-        {
-            val *= 1.0e-308;
-            a = iter;
-            goto on_success;
-        }
+    }
 
-        a = iter;
+    if (endPtr) *endPtr = (char *)iter;
 
-        while (expo_part >= 8U)
-        {
-            scale *= 1E8;
-            expo_part -= 8U;
-        }
-        while (expo_part > 0U)
-        {
-            scale *= 10.0f;
-            expo_part--;
-        }
-
-        val = (minus_e == -1) ? (val / scale) : (val * scale);
-    }
-    else if ((iter > nPtr) && !isdigit(*(iter - 1)))
-    {
-        a = nPtr;
-        goto on_success;
+    float val;
+    //Zero whatever the exponent is, not 0 * inf of the huge one.
+    if (mantissa == 0) {
+        val = 0.0f;
+    //Clinger's fast path: the mantissa and the power of 10 are both exact,
+    //so the single multiplication or division is correctly rounded.
+    } else if (mantissa <= (1 << 24) && exponent >= -10 && exponent <= 10) {
+        val = (exponent < 0) ? (float)mantissa / pow10f[-exponent] : (float)mantissa * pow10f[exponent];
+    } else if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        val = (float)((exponent < 0) ? (double)mantissa / pow10s[-exponent] : (double)mantissa * pow10s[exponent]);
+    } else {
+        val = (float)((double)mantissa * pow(10.0, exponent));
     }
 
-on_success:
-    if (endPtr) *endPtr = (char *)a;
-    return minus * val;
-
-on_error:
-    if (endPtr) *endPtr = (char *)nPtr;
-    return 0.0f;
+    return minus ? -val : val;
 }
 
 string svgUtilURLDecode(const char *src)
@@ -286,17 +262,31 @@ string svgUtilURLDecode(const char *src)
     return decoded;
 }
 
-string svgUtilBase64Decode(const char *src)
+size_t svgUtilBase64Decode(const char *src, char** decoded)
 {
-    if (!src) return nullptr;
+    *decoded = nullptr;
+    if (!src) return 0;
 
     auto length = strlen(src);
-    if (length == 0) return nullptr;
+    if (length == 0) return 0;
 
-    string decoded;
-    decoded.reserve(3*(1+(length >> 2)));
+    //The room for the whole bytes of the last block
+    auto output = (char*)malloc(3 * (length >> 2) + 16);
+    if (!output) return 0;
+
+    auto dst = output;
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+    auto end = src + length;
+#endif
 
     while (*src && *(src+1)) {
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+        if (src + 16 <= end && _base64Block(src, dst)) {
+            src += 16;
+            dst += 12;
+            continue;
+        }
+#endif
         if (*src <= 0x20) {
             ++src;
             continue;
@@ -304,17 +294,19 @@ string svgUtilBase64Decode(const char *src)
 
         auto value1 = _base64Value(src[0]);
         auto value2 = _base64Value(src[1]);
-        decoded += (value1 << 2) + ((value2 & 0x30) >> 4);
+        *dst++ = (value1 << 2) + ((value2 & 0x30) >> 4);
 
         if (!src[2] || src[2] == '=' || src[2] == '.') break;
         auto value3 = _base64Value(src[2]);
-        decoded += ((value2 & 0x0f) << 4) + ((value3 & 0x3c) >> 2);
+        *dst++ = ((value2 & 0x0f) << 4) + ((value3 & 0x3c) >> 2);
 
         if (!src[3] || src[3] == '=' || src[3] == '.') break;
         auto value4 = _base64Value(src[3]);
-        decoded += ((value3 & 0x03) << 6) + value4;
+        *dst++ = ((value3 & 0x03) << 6) + value4;
         src += 4;
     }
-    return decoded;
+
+    *decoded = output;
+    return dst - output;
 }
 
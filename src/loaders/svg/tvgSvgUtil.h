@@ -23,11 +23,67 @@
 #ifndef _TVG_SVG_UTIL_H_
 #define _TVG_SVG_UTIL_H_
 
+#include <type_traits>
 #include "tvgCommon.h"
 
+//Case insensitive FNV-1a mixed with a seed
+constexpr uint32_t svgUtilHash(const char* str, size_t len, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (size_t i = 0; i < len; ++i) {
+        auto c = str[i];
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+    }
+    return hash ^ (hash >> 16);
+}
+
+
+constexpr size_t svgUtilLength(const char* str)
+{
+    size_t len = 0;
+    while (str[len]) ++len;
+    return len;
+}
+
+
+//Collision free hash slots over the names of a static table, the seed is searched at compile time.
+template<uint32_t Size>
+struct SvgPerfectHash
+{
+    uint32_t seed;
+    uint8_t slots[Size];    //index of the name + 1, zero if empty
+
+    //Returns the index of the only candidate name, the caller must compare it.
+    int find(const char* str, size_t len) const
+    {
+        return int(slots[svgUtilHash(str, len, seed) & (Size - 1)]) - 1;
+    }
+};
+
+
+template<uint32_t Size, class T, size_t N, class Name>
+constexpr SvgPerfectHash<Size> svgUtilPerfectHash(const T (&table)[N], Name name)
+{
+    static_assert(N < 256 && Size > N && (Size & (Size - 1)) == 0, "Invalid perfect hash size");
+
+    for (uint32_t seed = 0; ; ++seed) {
+        SvgPerfectHash<Size> hash = {seed, {}};
+        auto collision = false;
+        for (size_t i = 0; i < N && !collision; ++i) {
+            auto slot = svgUtilHash(table[i].*name, svgUtilLength(table[i].*name), seed) & (Size - 1);
+            if (hash.slots[slot]) collision = true;
+            else hash.slots[slot] = uint8_t(i + 1);
+        }
+        if (!collision) return hash;
+    }
+}
+
+#define SVG_PERFECT_HASH(Size, Table, Field) svgUtilPerfectHash<Size>(Table, &std::remove_reference<decltype(Table[0])>::type::Field)
+
 float svgUtilStrtof(const char *nPtr, char **endPtr);
 
 string svgUtilURLDecode(const char *src);
-string svgUtilBase64Decode(const char *src);
+size_t svgUtilBase64Decode(const char *src, char** decoded);
 
 #endif //_TVG_SVG_UTIL_H_
@@ -20,7 +20,6 @@
  * SOFTWARE.
  */
 
-#include <ctype.h>
 #include <string>
 
 #ifdef _WIN32
@@ -31,6 +30,10 @@
 
 #include "tvgXmlParser.h"
 
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+    #include <immintrin.h>
+#endif
+
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
@@ -112,10 +115,68 @@ bool _isIgnoreUnsupportedLogAttributes(const char* tagAttribute, const char* tag
 
 #endif
 
+static inline bool _isSpace(char c)
+{
+    return (c == ' ') || ((unsigned char)(c - '\t') <= '\r' - '\t');
+}
+
+
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+
+//ctz: count trailing zero's
+#ifdef _MSC_VER
+    #include <intrin.h>
+    static uint32_t __inline _ctz(uint32_t value)
+    {
+        unsigned long trailingZero = 0;
+        _BitScanForward(&trailingZero, value);
+        return trailingZero;
+    }
+#else
+    #define _ctz(x) __builtin_ctz((x))
+#endif
+
+/* The scanners below classify 16 bytes at a time into bitmasks,
+   one bit per byte, and only look at the individual bytes whose bit is set. */
+
+static inline uint32_t _mask(__m128i v)
+{
+    return (uint32_t)_mm_movemask_epi8(v);
+}
+
+
+static inline uint32_t _spaceMask(__m128i v)
+{
+    //' ' or one of '\t', '\n', '\v', '\f', '\r'
+    auto ctrl = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    auto isCtrl = _mm_cmpeq_epi8(_mm_min_epu8(ctrl, _mm_set1_epi8('\r' - '\t')), ctrl);
+    return _mask(_mm_or_si128(isCtrl, _mm_cmpeq_epi8(v, _mm_set1_epi8(' '))));
+}
+
+
+//Every bit is the parity of the bits at and below it: set within the quoted ranges.
+static inline uint32_t _prefixXor(uint32_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    return bits & 0xffff;
+}
+
+#endif
+
+
 static const char* _simpleXmlFindWhiteSpace(const char* itr, const char* itrEnd)
 {
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+    for (; itr + 16 <= itrEnd; itr += 16) {
+        auto bits = _spaceMask(_mm_loadu_si128((__m128i*)itr));
+        if (bits) return itr + _ctz(bits);
+    }
+#endif
     for (; itr < itrEnd; itr++) {
-        if (isspace((unsigned char)*itr)) break;
+        if (_isSpace(*itr)) break;
     }
     return itr;
 }
@@ -123,8 +184,16 @@ static const char* _simpleXmlFindWhiteSpace(const char* itr, const char* itrEnd)
 
 static const char* _simpleXmlSkipWhiteSpace(const char* itr, const char* itrEnd)
 {
+    //Most runs are a single separator, don't bother the vector unit for them.
+    if (itr < itrEnd && !_isSpace(*itr)) return itr;
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+    for (; itr + 16 <= itrEnd; itr += 16) {
+        auto bits = ~_spaceMask(_mm_loadu_si128((__m128i*)itr)) & 0xffff;
+        if (bits) return itr + _ctz(bits);
+    }
+#endif
     for (; itr < itrEnd; itr++) {
-        if (!isspace((unsigned char)*itr)) break;
+        if (!_isSpace(*itr)) break;
     }
     return itr;
 }
@@ -133,7 +202,7 @@ static const char* _simpleXmlSkipWhiteSpace(const char* itr, const char* itrEnd)
 static const char* _simpleXmlUnskipWhiteSpace(const char* itr, const char* itrStart)
 {
     for (itr--; itr > itrStart; itr--) {
-        if (!isspace((unsigned char)*itr)) break;
+        if (!_isSpace(*itr)) break;
     }
     return itr + 1;
 }
@@ -211,6 +280,21 @@ static const char* _simpleXmlFindStartTag(const char* itr, const char* itrEnd)
 static const char* _simpleXmlFindEndTag(const char* itr, const char* itrEnd)
 {
     bool insideQuote = false;
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+    auto quote = _mm_set1_epi8('"');
+    auto open = _mm_set1_epi8('<');
+    auto close = _mm_set1_epi8('>');
+    for (; itr + 16 <= itrEnd; itr += 16) {
+        auto v = _mm_loadu_si128((__m128i*)itr);
+        auto quotes = _mask(_mm_cmpeq_epi8(v, quote));
+        auto tags = _mask(_mm_or_si128(_mm_cmpeq_epi8(v, open), _mm_cmpeq_epi8(v, close)));
+        auto quoted = _prefixXor(quotes);
+        if (insideQuote) quoted ^= 0xffff;
+        tags &= ~quoted;
+        if (tags) return itr + _ctz(tags);
+        insideQuote = quoted & 0x8000;
+    }
+#endif
     for (; itr < itrEnd; itr++) {
         if (*itr == '"') insideQuote = !insideQuote;
         if (!insideQuote) {
@@ -242,88 +326,13 @@ static const char* _simpleXmlFindEndCdataTag(const char* itr, const char* itrEnd
 
 static const char* _simpleXmlFindDoctypeChildEndTag(const char* itr, const char* itrEnd)
 {
-    for (; itr < itrEnd; itr++) {
-        if (*itr == '>') return itr;
-    }
-    return nullptr;
+    return (const char*)memchr(itr, '>', itrEnd - itr);
 }
 
 
-/************************************************************************/
-/* External Class Implementation                                        */
-/************************************************************************/
-
-
-bool simpleXmlParseAttributes(const char* buf, unsigned bufLength, simpleXMLAttributeCb func, const void* data)
-{
-    const char *itr = buf, *itrEnd = buf + bufLength;
-    char* tmpBuf = (char*)alloca(bufLength + 1);
-
-    if (!buf || !func) return false;
-
-    while (itr < itrEnd) {
-        const char* p = _skipWhiteSpacesAndXmlEntities(itr, itrEnd);
-        const char *key, *keyEnd, *value, *valueEnd;
-        char* tval;
-
-        if (p == itrEnd) return true;
-
-        key = p;
-        for (keyEnd = key; keyEnd < itrEnd; keyEnd++) {
-            if ((*keyEnd == '=') || (isspace((unsigned char)*keyEnd))) break;
-        }
-        if (keyEnd == itrEnd) return false;
-        if (keyEnd == key) continue;
-
-        if (*keyEnd == '=') value = keyEnd + 1;
-        else {
-            value = (const char*)memchr(keyEnd, '=', itrEnd - keyEnd);
-            if (!value) return false;
-            value++;
-        }
-        keyEnd = _simpleXmlUnskipXmlEntities(keyEnd, key);
-
-        value = _skipWhiteSpacesAndXmlEntities(value, itrEnd);
-        if (value == itrEnd) return false;
-
-        if ((*value == '"') || (*value == '\'')) {
-            valueEnd = (const char*)memchr(value + 1, *value, itrEnd - value);
-            if (!valueEnd) return false;
-            value++;
-        } else {
-            valueEnd = _simpleXmlFindWhiteSpace(value, itrEnd);
-        }
-
-        itr = valueEnd + 1;
-
-        value = _skipWhiteSpacesAndXmlEntities(value, itrEnd);
-        valueEnd = _unskipWhiteSpacesAndXmlEntities(valueEnd, value);
-
-        memcpy(tmpBuf, key, keyEnd - key);
-        tmpBuf[keyEnd - key] = '\0';
-
-        tval = tmpBuf + (keyEnd - key) + 1;
-        int i = 0;
-        while (value < valueEnd) {
-            value = _simpleXmlSkipXmlEntities(value, valueEnd);
-            tval[i++] = *value;
-            value++;
-        }
-        tval[i] = '\0';
-
-#ifdef THORVG_LOG_ENABLED
-        if (!func((void*)data, tmpBuf, tval)) {
-            if (!_isIgnoreUnsupportedLogAttributes(tmpBuf, tval)) printf("SVG: Unsupported attributes used [Elements type: %s][Id : %s][Attribute: %s][Value: %s]\n", simpleXmlNodeTypeToString(((SvgLoaderData*)data)->svgParse->node->type).c_str(), ((SvgLoaderData*)data)->svgParse->node->id ? ((SvgLoaderData*)data)->svgParse->node->id->c_str() : "NO_ID", tmpBuf, tval ? tval : "NONE");
-        }
-#else
-        func((void*)data, tmpBuf, tval);
-#endif
-    }
-    return true;
-}
-
-
-bool simpleXmlParse(const char* buf, unsigned bufLength, bool strip, simpleXMLCb func, const void* data)
+/* With the rest, the items cut off at the end of the buf are left unparsed and
+   the rest points to the first of them, so the parse can go on with more data. */
+static bool _simpleXmlParse(const char* buf, unsigned bufLength, bool strip, simpleXMLCb func, const void* data, const char** rest)
 {
     const char *itr = buf, *itrEnd = buf + bufLength;
 
@@ -340,6 +349,8 @@ bool simpleXmlParse(const char* buf, unsigned bufLength, bool strip, simpleXMLCb
 
     while (itr < itrEnd) {
         if (itr[0] == '<') {
+            //Not enough to tell the type of the tag yet.
+            if (rest && ((itr + 1 >= itrEnd) || ((itr[1] == '!') && (itr + sizeof("<![CDATA[]]>") - 1 > itrEnd)))) break;
             if (itr + 1 >= itrEnd) {
                 CB(SimpleXMLType::Error, itr, itrEnd);
                 return false;
@@ -355,7 +366,7 @@ bool simpleXmlParse(const char* buf, unsigned bufLength, bool strip, simpleXMLCb
                     type = SimpleXMLType::Processing;
                     toff = 1;
                 } else if (itr[1] == '!') {
-                    if ((itr + sizeof("<!DOCTYPE>") - 1 < itrEnd) && (!memcmp(itr + 2, "DOCTYPE", sizeof("DOCTYPE") - 1)) && ((itr[2 + sizeof("DOCTYPE") - 1] == '>') || (isspace((unsigned char)itr[2 + sizeof("DOCTYPE") - 1])))) {
+                    if ((itr + sizeof("<!DOCTYPE>") - 1 < itrEnd) && (!memcmp(itr + 2, "DOCTYPE", sizeof("DOCTYPE") - 1)) && ((itr[2 + sizeof("DOCTYPE") - 1] == '>') || (_isSpace(itr[2 + sizeof("DOCTYPE") - 1])))) {
                         type = SimpleXMLType::Doctype;
                         toff = sizeof("!DOCTYPE") - 1;
                     } else if ((itr + sizeof("<!---->") - 1 < itrEnd) && (!memcmp(itr + 2, "--", sizeof("--") - 1))) {
@@ -381,6 +392,8 @@ bool simpleXmlParse(const char* buf, unsigned bufLength, bool strip, simpleXMLCb
                 else if (type == SimpleXMLType::Comment) p = _simpleXmlFindEndCommentTag(itr + 1 + toff, itrEnd);
                 else p = _simpleXmlFindEndTag(itr + 1 + toff, itrEnd);
 
+                if (!p && rest) break;
+
                 if ((p) && (*p == '<')) {
                     type = SimpleXMLType::Error;
                     toff = 0;
@@ -432,7 +445,13 @@ bool simpleXmlParse(const char* buf, unsigned bufLength, bool strip, simpleXMLCb
                 }
             }
         } else {
-            const char *p, *end;
+            const char *p, *end, *tag;
+
+            tag = _simpleXmlFindStartTag(itr, itrEnd);
+            if (!tag) {
+                if (rest) break;
+                tag = itrEnd;
+            }
 
             if (strip) {
                 p = itr;
@@ -443,8 +462,7 @@ bool simpleXmlParse(const char* buf, unsigned bufLength, bool strip, simpleXMLCb
                 }
             }
 
-            p = _simpleXmlFindStartTag(itr, itrEnd);
-            if (!p) p = itrEnd;
+            p = tag;
 
             end = p;
             if (strip) end = _unskipWhiteSpacesAndXmlEntities(end, itr);
@@ -459,10 +477,107 @@ bool simpleXmlParse(const char* buf, unsigned bufLength, bool strip, simpleXMLCb
 
 #undef CB
 
+    if (rest) *rest = itr;
+
     return true;
 }
 
 
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+
+bool simpleXmlParseAttributes(const char* buf, unsigned bufLength, simpleXMLAttributeCb func, const void* data)
+{
+    const char *itr = buf, *itrEnd = buf + bufLength;
+    char* tmpBuf = (char*)alloca(bufLength + 1);
+
+    if (!buf || !func) return false;
+
+    while (itr < itrEnd) {
+        const char* p = _skipWhiteSpacesAndXmlEntities(itr, itrEnd);
+        const char *key, *keyEnd, *value, *valueEnd;
+        char* tval;
+
+        if (p == itrEnd) return true;
+
+        key = p;
+        for (keyEnd = key; keyEnd < itrEnd; keyEnd++) {
+            if ((*keyEnd == '=') || (_isSpace(*keyEnd))) break;
+        }
+        if (keyEnd == itrEnd) return false;
+        if (keyEnd == key) continue;
+
+        if (*keyEnd == '=') value = keyEnd + 1;
+        else {
+            value = (const char*)memchr(keyEnd, '=', itrEnd - keyEnd);
+            if (!value) return false;
+            value++;
+        }
+        keyEnd = _simpleXmlUnskipXmlEntities(keyEnd, key);
+
+        value = _skipWhiteSpacesAndXmlEntities(value, itrEnd);
+        if (value == itrEnd) return false;
+
+        if ((*value == '"') || (*value == '\'')) {
+            valueEnd = (const char*)memchr(value + 1, *value, itrEnd - value);
+            if (!valueEnd) return false;
+            value++;
+        } else {
+            valueEnd = _simpleXmlFindWhiteSpace(value, itrEnd);
+        }
+
+        itr = valueEnd + 1;
+
+        value = _skipWhiteSpacesAndXmlEntities(value, itrEnd);
+        valueEnd = _unskipWhiteSpacesAndXmlEntities(valueEnd, value);
+
+        memcpy(tmpBuf, key, keyEnd - key);
+        tmpBuf[keyEnd - key] = '\0';
+
+        tval = tmpBuf + (keyEnd - key) + 1;
+        //Entities are dropped from the value, plain values go in one copy.
+        if (!memchr(value, '&', valueEnd - value)) {
+            memcpy(tval, value, valueEnd - value);
+            tval[valueEnd - value] = '\0';
+        } else {
+            int i = 0;
+            while (value < valueEnd) {
+                value = _simpleXmlSkipXmlEntities(value, valueEnd);
+                tval[i++] = *value;
+                value++;
+            }
+            tval[i] = '\0';
+        }
+
+#ifdef THORVG_LOG_ENABLED
+        if (!func((void*)data, tmpBuf, tval)) {
+            if (!_isIgnoreUnsupportedLogAttributes(tmpBuf, tval)) printf("SVG: Unsupported attributes used [Elements type: %s][Id : %s][Attribute: %s][Value: %s]\n", simpleXmlNodeTypeToString(((SvgLoaderData*)data)->svgParse->node->type).c_str(), ((SvgLoaderData*)data)->svgParse->node->id ? ((SvgLoaderData*)data)->svgParse->node->id->c_str() : "NO_ID", tmpBuf, tval ? tval : "NONE");
+        }
+#else
+        func((void*)data, tmpBuf, tval);
+#endif
+    }
+    return true;
+}
+
+
+bool simpleXmlParse(const char* buf, unsigned bufLength, bool strip, simpleXMLCb func, const void* data)
+{
+    return _simpleXmlParse(buf, bufLength, strip, func, data, nullptr);
+}
+
+
+bool simpleXmlParseChunk(const char* buf, unsigned bufLength, bool strip, simpleXMLCb func, const void* data, unsigned* parsed)
+{
+    const char* rest = buf;
+    auto ret = _simpleXmlParse(buf, bufLength, strip, func, data, &rest);
+    if (parsed) *parsed = rest - buf;
+    return ret;
+}
+
+
 bool simpleXmlParseW3CAttribute(const char* buf, simpleXMLAttributeCb func, const void* data)
 {
     const char* end;
@@ -529,7 +644,7 @@ const char* simpleXmlFindAttributesTag(const char* buf, unsigned bufLength)
     const char *itr = buf, *itrEnd = buf + bufLength;
 
     for (; itr < itrEnd; itr++) {
-        if (!isspace((unsigned char)*itr)) {
+        if (!_isSpace(*itr)) {
             //User skip tagname and already gave it the attributes.
             if (*itr == '=') return buf;
         } else {
@@ -49,6 +49,7 @@ typedef bool (*simpleXMLAttributeCb)(void* data, const char* key, const char* va
 
 bool simpleXmlParseAttributes(const char* buf, unsigned buflen, simpleXMLAttributeCb func, const void* data);
 bool simpleXmlParse(const char* buf, unsigned buflen, bool strip, simpleXMLCb func, const void* data);
+bool simpleXmlParseChunk(const char* buf, unsigned buflen, bool strip, simpleXMLCb func, const void* data, unsigned* parsed);
 bool simpleXmlParseW3CAttribute(const char* buf, simpleXMLAttributeCb func, const void* data);
 const char *simpleXmlFindAttributesTag(const char* buf, unsigned buflen);
 
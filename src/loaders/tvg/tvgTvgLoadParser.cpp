@@ -21,7 +21,12 @@
  */
 
 #include <memory.h>
+#include <atomic>
+#include "tvgTaskScheduler.h"
 #include "tvgTvgLoadParser.h"
+#include "tvgShapeImpl.h"
+#include "tvgArray.h"
+#include "tvgCompressor.h"
 
 
 /************************************************************************/
@@ -30,7 +35,9 @@
 
 enum class LoaderResult { Success = 0, InvalidType, SizeCorruption, MemoryCorruption, LogicalCorruption };
 
-static Paint* _parsePaint(tvgBlock block);
+struct TvgDecoder;
+
+static Paint* _parsePaint(tvgBlock block, TvgDecoder** decoders = nullptr);
 
 
 static bool _paintProperty(tvgBlock block)
@@ -45,6 +52,19 @@ static bool _paintProperty(tvgBlock block)
 }
 
 
+static bool _paintBegin(TvgIndicator type)
+{
+    switch (type) {
+        case TVG_SCENE_BEGIN_INDICATOR:
+        case TVG_SHAPE_BEGIN_INDICATOR:
+        case TVG_PICTURE_BEGIN_INDICATOR:
+        case TVG_COMPRESSED_BLOCK_INDICATOR:
+        return true;
+    }
+    return false;
+}
+
+
 static tvgBlock _readBlock(const char *ptr)
 {
     tvgBlock block;
@@ -55,29 +75,238 @@ static tvgBlock _readBlock(const char *ptr)
     return block;
 }
 
-static bool _readTvgHeader(const char **ptr)
+
+//Minimum bytes of the children decoded by a job
+#define DECODE_JOB_SIZE (32 * 1024)
+
+struct TvgDecodeTask : Task
+{
+    TvgDecoder* decoder;
+    void run(unsigned tid) override;
+};
+
+
+struct TvgDecoder
+{
+    TvgDecoder* prev = nullptr;     //the one started before for the same data
+    const char* data;               //scene data the offsets start from
+    const char* end;                //end of the last child
+    Array<uint32_t> offsets;        //children by the index or by the scan
+    Array<Paint*> paints;           //decoded children, nullptr if invalid
+    Array<uint32_t> jobs;           //the first child of each job, and the end of the last one
+    Array<TvgDecodeTask*> tasks;
+    atomic<uint32_t> next{0};
+    atomic<uint32_t> finished{0};
+    mutex mtx;
+    condition_variable cv;
+
+    //Freed by the loader, not by a worker waiting for the queued tasks.
+    ~TvgDecoder()
+    {
+        //The tasks may still be queued, even though there is nothing left for them.
+        for (uint32_t i = 0; i < tasks.count; ++i) {
+            tasks.data[i]->done();
+            delete(tasks.data[i]);
+        }
+    }
+
+    //The child must fill the room up to the next one in the index.
+    Paint* decode(uint32_t idx)
+    {
+        auto ptr = data + offsets.data[idx];
+        auto limit = (idx + 1 < offsets.count) ? data + offsets.data[idx + 1] : end;
+        if (ptr + TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE > limit) return nullptr;
+
+        auto block = _readBlock(ptr);
+        if (block.end != limit || !_paintBegin(block.type)) return nullptr;
+        return _parsePaint(block);
+    }
+
+    bool process()
+    {
+        auto job = next++;
+        if (job + 1 >= jobs.count) return false;
+
+        for (auto i = jobs.data[job]; i < jobs.data[job + 1]; ++i) {
+            paints.data[i] = decode(i);
+        }
+
+        if (++finished == jobs.count - 1) {
+            lock_guard<mutex> lock(mtx);
+            cv.notify_one();
+        }
+        return true;
+    }
+
+    //Split the children into the jobs of the similar sizes, a few per thread to balance them.
+    bool split()
+    {
+        auto threads = TaskScheduler::threads();
+        auto bytes = static_cast<uint32_t>(end - data) - offsets.data[0];
+        auto jobSize = bytes / (threads * 4);
+        if (jobSize < DECODE_JOB_SIZE) jobSize = DECODE_JOB_SIZE;
+        if (bytes < jobSize * 2) return false;
+
+        jobs.push(0);
+        auto begin = offsets.data[0];
+        for (uint32_t i = 1; i < offsets.count; ++i) {
+            if (offsets.data[i] - begin < jobSize) continue;
+            jobs.push(i);
+            begin = offsets.data[i];
+        }
+        jobs.push(offsets.count);
+        return (jobs.count > 2);
+    }
+
+    void run()
+    {
+        paints.reserve(offsets.count);
+        paints.count = offsets.count;
+
+        //The calling thread is a worker as well, it takes the jobs the others don't reach.
+        auto cnt = TaskScheduler::threads() - 1;
+        if (cnt > jobs.count - 2) cnt = jobs.count - 2;
+        tasks.reserve(cnt);
+        for (uint32_t i = 0; i < cnt; ++i) {
+            auto task = new TvgDecodeTask;
+            task->decoder = this;
+            tasks.push(task);
+            TaskScheduler::request(task);
+        }
+
+        while (process());
+
+        //Never wait for the queued tasks, but for the jobs in progress.
+        unique_lock<mutex> lock(mtx);
+        while (finished < jobs.count - 1) cv.wait(lock);
+    }
+};
+
+
+void TvgDecodeTask::run(unsigned tid)
+{
+    while (decoder->process());
+}
+
+
+/* Only the index itself is read here, ascending offsets in the scene. The children are checked
+   against it while they are decoded, not to walk over all of them twice. */
+static bool _readSceneIndex(tvgBlock baseBlock, TvgDecoder& decoder)
+{
+    if (baseBlock.length < TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE) return false;
+
+    auto index = _readBlock(baseBlock.data);
+    if (index.type != TVG_SCENE_INDEX_INDICATOR || index.end > baseBlock.end) return false;
+    if (index.length == 0 || index.length % sizeof(uint32_t)) return false;
+
+    auto cnt = index.length / sizeof(uint32_t);
+    if (!decoder.offsets.reserve(cnt)) return false;
+
+    //The last offset is the scene data length when the index is past the end.
+    auto prev = static_cast<uint32_t>(index.end - baseBlock.data);
+    auto last = baseBlock.length - (TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE);
+    for (uint32_t i = 0; i < cnt; ++i) {
+        uint32_t offset;
+        _read_tvg_ui32(&offset, index.data + i * sizeof(uint32_t));
+        if (offset < prev || offset > last || (i > 0 && offset == prev)) return false;
+        decoder.offsets.push(offset);
+        prev = offset;
+    }
+
+    auto block = _readBlock(baseBlock.data + prev);
+    if (block.end > baseBlock.end) return false;
+
+    decoder.data = baseBlock.data;
+    decoder.end = block.end;
+    return true;
+}
+
+
+//Walks over the lengths of the children only, the scene without the index.
+static bool _scanScene(tvgBlock baseBlock, TvgDecoder& decoder)
+{
+    decoder.offsets.clear();
+
+    auto ptr = baseBlock.data;
+    while (ptr + TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE <= baseBlock.end) {
+        auto block = _readBlock(ptr);
+        if (block.end > baseBlock.end || !_paintBegin(block.type)) break;
+        decoder.offsets.push(static_cast<uint32_t>(ptr - baseBlock.data));
+        ptr = block.end;
+    }
+    if (decoder.offsets.count < 2) return false;
+
+    decoder.data = baseBlock.data;
+    decoder.end = ptr;
+    return true;
+}
+
+
+/* Decode the children ahead of the properties, and returns the position after them.
+   The children of the first large scenes down the tree are decoded by the workers. */
+static const char* _parseChildren(tvgBlock baseBlock, Paint* paint, TvgDecoder** decoders)
+{
+    if (baseBlock.type == TVG_SHAPE_BEGIN_INDICATOR) return baseBlock.data;
+
+    //Too small to share with the others, so are the descendants.
+    if (baseBlock.length < DECODE_JOB_SIZE * 2) return baseBlock.data;
+
+    if (baseBlock.type == TVG_SCENE_BEGIN_INDICATOR) {
+        auto decoder = new TvgDecoder;
+        if ((_readSceneIndex(baseBlock, *decoder) || _scanScene(baseBlock, *decoder)) && decoder->split()) {
+            decoder->prev = *decoders;
+            *decoders = decoder;
+            decoder->run();
+            auto scene = static_cast<Scene*>(paint);
+            scene->reserve(decoder->paints.count);
+            for (uint32_t i = 0; i < decoder->paints.count; ++i) {
+                scene->push(unique_ptr<Paint>(decoder->paints.data[i]));
+            }
+            return decoder->end;
+        }
+        delete(decoder);
+    }
+
+    //Look for them further down.
+    auto ptr = baseBlock.data;
+    while (ptr + TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE <= baseBlock.end) {
+        auto block = _readBlock(ptr);
+        if (block.end > baseBlock.end) break;
+        if (block.type != TVG_SCENE_INDEX_INDICATOR) {
+            if (!_paintBegin(block.type)) break;
+            if (auto child = _parsePaint(block, decoders)) {
+                if (baseBlock.type == TVG_SCENE_BEGIN_INDICATOR) static_cast<Scene*>(paint)->push(unique_ptr<Paint>(child));
+                else static_cast<Picture*>(paint)->paint(unique_ptr<Paint>(child));
+            }
+        }
+        ptr = block.end;
+    }
+    return ptr;
+}
+
+
+static bool _readTvgHeader(const char **ptr, const char *end, const char **meta = nullptr, uint16_t* metaLen = nullptr)
 {
-    if (!*ptr) return false;
+    if (!*ptr || end - *ptr < TVG_BIN_HEADER_SIGNATURE_LENGTH + TVG_BIN_HEADER_VERSION_LENGTH + TVG_BIN_HEADER_DATA_LENGTH) return false;
 
     //Sign phase, always TVG_BIN_HEADER_SIGNATURE is declared
     if (memcmp(*ptr, TVG_BIN_HEADER_SIGNATURE, TVG_BIN_HEADER_SIGNATURE_LENGTH)) return false;
     *ptr += TVG_BIN_HEADER_SIGNATURE_LENGTH;
 
-    //Version number, declared in TVG_BIN_HEADER_VERSION
-    if (memcmp(*ptr, TVG_BIN_HEADER_VERSION, TVG_BIN_HEADER_VERSION_LENGTH)) return false;
+    //Version number, declared in TVG_BIN_HEADER_VERSION. The older ones are read as well, not the newer ones.
+    if (memcmp(*ptr, TVG_BIN_HEADER_VERSION, TVG_BIN_HEADER_VERSION_LENGTH) > 0) return false;
     *ptr += TVG_BIN_HEADER_VERSION_LENGTH;
 
     //Meta data for proof?
-    uint16_t metaLen;
-    _read_tvg_ui16(&metaLen, *ptr);
+    uint16_t len;
+    _read_tvg_ui16(&len, *ptr);
     *ptr += 2;
+    if (len > end - *ptr) return false;
 
-    //Meta data... Need to replace checksum way.
-    //char metadata[metaLen + 1];
-    //memcpy(metadata, *ptr, metaLen);
-    //metadata[metaLen] = '\0';
+    if (meta) *meta = *ptr;
+    if (metaLen) *metaLen = len;
 
-    *ptr += metaLen;
+    *ptr += len;
 
     return true;
 }
@@ -172,20 +401,84 @@ static LoaderResult _parseScene(tvgBlock block, Paint *paint)
 static LoaderResult _parseShapePath(const char *ptr, const char *end, Shape *shape)
 {
     //Shape Path
+    if (end - ptr < static_cast<int64_t>(2 * sizeof(uint32_t))) return LoaderResult::SizeCorruption;
     uint32_t cmdCnt, ptsCnt;
     _read_tvg_ui32(&cmdCnt, ptr);
     ptr += sizeof(uint32_t);
     _read_tvg_ui32(&ptsCnt, ptr);
     ptr += sizeof(uint32_t);
 
-    const PathCommand* cmds = (PathCommand*) ptr;
+    if (static_cast<uint64_t>(sizeof(PathCommand)) * cmdCnt + static_cast<uint64_t>(sizeof(Point)) * ptsCnt > static_cast<uint64_t>(end - ptr)) return LoaderResult::SizeCorruption;
+    if (cmdCnt == 0 || ptsCnt == 0) return LoaderResult::Success;
+
+    //The path refers the arrays in one block, shared with its duplicates.
+    auto source = ShapePathSource::gen(sizeof(Point) * ptsCnt + sizeof(PathCommand) * cmdCnt);
+    if (!source) return LoaderResult::MemoryCorruption;
+    auto pts = static_cast<Point*>(source->data());
+    auto cmds = reinterpret_cast<PathCommand*>(pts + ptsCnt);
+
+    memcpy(cmds, ptr, sizeof(PathCommand) * cmdCnt);
     ptr += sizeof(PathCommand) * cmdCnt;
-    const Point* pts = (Point*) ptr;
-    ptr += sizeof(Point) * ptsCnt;
+    memcpy(pts, ptr, sizeof(Point) * ptsCnt);
 
-    if (ptr > end) return LoaderResult::SizeCorruption;
+    P(shape)->sharePath(source, cmds, cmdCnt, pts, ptsCnt);
+    source->unref();
+    return LoaderResult::Success;
+}
+
+
+static bool _readVarint(const char **ptr, const char *end, uint64_t *value)
+{
+    *value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (*ptr >= end) return false;
+        auto byte = static_cast<uint8_t>(*(*ptr)++);
+        *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+
+static LoaderResult _parseShapeQuantizedPath(const char *ptr, const char *end, Shape *shape)
+{
+    uint64_t cmdCnt, ptsCnt;
+    if (!_readVarint(&ptr, end, &cmdCnt) || !_readVarint(&ptr, end, &ptsCnt) || ptr >= end) return LoaderResult::SizeCorruption;
+
+    auto precision = static_cast<uint8_t>(*ptr++);
+    if (precision > TVG_SHAPE_PATH_PRECISION_MAX) return LoaderResult::LogicalCorruption;
+
+    //Each point takes 2 bytes at least.
+    if (cmdCnt > UINT32_MAX || ptsCnt > UINT32_MAX) return LoaderResult::SizeCorruption;
+    auto cmdByteCnt = (cmdCnt + 3) / 4;
+    if (cmdByteCnt > static_cast<uint64_t>(end - ptr) || ptsCnt * 2 > static_cast<uint64_t>(end - ptr) - cmdByteCnt) return LoaderResult::SizeCorruption;
+
+    //Decoded into the arrays the path refers.
+    if (cmdCnt == 0 || ptsCnt == 0) return LoaderResult::Success;
+    auto source = ShapePathSource::gen(sizeof(Point) * ptsCnt + sizeof(PathCommand) * cmdCnt);
+    if (!source) return LoaderResult::MemoryCorruption;
+    auto pts = static_cast<Point*>(source->data());
+    auto cmds = reinterpret_cast<PathCommand*>(pts + ptsCnt);
+
+    for (uint32_t i = 0; i < cmdCnt; ++i) {
+        cmds[i] = static_cast<PathCommand>((ptr[i >> 2] >> ((i & 0x03) << 1)) & 0x03);
+    }
+    ptr += cmdByteCnt;
+
+    uint64_t x = 0, y = 0;
+    for (uint32_t i = 0; i < ptsCnt; ++i) {
+        uint64_t dx, dy;
+        if (!_readVarint(&ptr, end, &dx) || !_readVarint(&ptr, end, &dy)) {
+            source->unref();
+            return LoaderResult::SizeCorruption;
+        }
+        x += (dx >> 1) ^ -(dx & 1);
+        y += (dy >> 1) ^ -(dy & 1);
+        pts[i] = {_tvgDequantize(static_cast<int64_t>(x), precision), _tvgDequantize(static_cast<int64_t>(y), precision)};
+    }
 
-    shape->appendPath(cmds, cmdCnt, pts, ptsCnt);
+    P(shape)->sharePath(source, cmds, cmdCnt, pts, ptsCnt);
+    source->unref();
     return LoaderResult::Success;
 }
 
@@ -194,7 +487,7 @@ static LoaderResult _parseShapeFill(const char *ptr, const char *end, Fill **fil
 {
     unique_ptr<Fill> fillGrad;
 
-    while (ptr < end) {
+    while (ptr + TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE <= end) {
         auto block = _readBlock(ptr);
         if (block.end > end) return LoaderResult::SizeCorruption;
 
@@ -296,7 +589,7 @@ static LoaderResult _parseShapeStrokeDashPattern(const char *ptr, const char *en
 
 static LoaderResult _parseShapeStroke(const char *ptr, const char *end, Shape *shape)
 {
-    while (ptr < end) {
+    while (ptr + TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE <= end) {
         auto block = _readBlock(ptr);
         if (block.end > end) return LoaderResult::SizeCorruption;
 
@@ -372,6 +665,11 @@ static LoaderResult _parseShape(tvgBlock block, Paint* paint)
             if (result != LoaderResult::Success) return result;
             break;
         }
+        case TVG_SHAPE_QUANTIZED_PATH_INDICATOR: {
+            auto result = _parseShapeQuantizedPath(block.data, block.end, shape);
+            if (result != LoaderResult::Success) return result;
+            break;
+        }
         case TVG_SHAPE_STROKE_INDICATOR: {
             auto result = _parseShapeStroke(block.data, block.end, shape);
             if (result != LoaderResult::Success) return result;
@@ -443,12 +741,38 @@ static LoaderResult _parsePicture(tvgBlock block, Paint* paint)
 }
 
 
-static Paint* _parsePaint(tvgBlock baseBlock)
+/* The paint is decompressed at once, and parsed from there as it is from the data.
+   The workers are done with it when the parsing returns. */
+static Paint* _parseCompressedPaint(tvgBlock baseBlock, TvgDecoder** decoders)
+{
+    if (baseBlock.length < TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE) return nullptr;
+
+    auto block = _readBlock(baseBlock.data);
+    if (block.type == TVG_COMPRESSED_BLOCK_INDICATOR || !_paintBegin(block.type)) return nullptr;
+
+    //Not more than the format can expand to.
+    auto compressedByteCnt = static_cast<uint32_t>(baseBlock.end - block.data);
+    if (block.length / 255 > compressedByteCnt) return nullptr;
+
+    auto data = static_cast<char*>(malloc(block.length));
+    if (!data) return nullptr;
+
+    Paint* paint = nullptr;
+    if (lz4Decompress(block.data, compressedByteCnt, data, block.length)) {
+        paint = _parsePaint({block.type, block.length, data, data + block.length}, decoders);
+    }
+    free(data);
+    return paint;
+}
+
+
+static Paint* _parsePaint(tvgBlock baseBlock, TvgDecoder** decoders)
 {
     LoaderResult (*parser)(tvgBlock, Paint*);
     Paint *paint = nullptr;
 
     switch (baseBlock.type) {
+        case TVG_COMPRESSED_BLOCK_INDICATOR: return _parseCompressedPaint(baseBlock, decoders);
         case TVG_SCENE_BEGIN_INDICATOR: {
             paint = Scene::gen().release();
             parser = _parseScene;
@@ -468,8 +792,9 @@ static Paint* _parsePaint(tvgBlock baseBlock)
     }
 
     auto ptr = baseBlock.data;
+    if (decoders) ptr = _parseChildren(baseBlock, paint, decoders);
 
-    while (ptr < baseBlock.end) {
+    while (ptr + TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE <= baseBlock.end) {
         auto block = _readBlock(ptr);
         if (block.end > baseBlock.end) return paint;
         auto result = parser(block, paint);
@@ -487,15 +812,27 @@ static Paint* _parsePaint(tvgBlock baseBlock)
 bool tvgValidateData(const char *ptr, uint32_t size)
 {
     auto end = ptr + size;
-    if (!_readTvgHeader(&ptr) || ptr >= end) return false;
+    if (!_readTvgHeader(&ptr, end) || ptr >= end) return false;
     return true;
 }
 
-unique_ptr<Scene> tvgLoadData(const char *ptr, uint32_t size)
+bool tvgReadViewbox(const char *ptr, uint32_t size, float* viewbox, bool* preserveAspect)
 {
     auto end = ptr + size;
+    const char* meta;
+    uint16_t metaLen;
+    if (!_readTvgHeader(&ptr, end, &meta, &metaLen) || metaLen != TVG_BIN_HEADER_META_VIEWBOX_LENGTH) return false;
+
+    memcpy(viewbox, meta, 6 * sizeof(float));
+    *preserveAspect = meta[6 * sizeof(float)] ? true : false;
+    return true;
+}
 
-    if (!_readTvgHeader(&ptr) || ptr >= end) {
+unique_ptr<Scene> tvgLoadData(const char *ptr, uint32_t size, TvgDecoder** decoders)
+{
+    auto end = ptr + size;
+
+    if (!_readTvgHeader(&ptr, end) || ptr >= end) {
 #ifdef THORVG_LOG_ENABLED
         printf("TVG_LOADER: Invalid TVG Data!\n");
 #endif
@@ -505,7 +842,13 @@ unique_ptr<Scene> tvgLoadData(const char *ptr, uint32_t size)
     auto scene = Scene::gen();
     if (!scene) return nullptr;
 
-    while (ptr < end) {
+    //The blocks are the children of the scene, decoded by the workers when they are large.
+    if (TaskScheduler::threads() > 1) {
+        tvgBlock block = {TVG_SCENE_BEGIN_INDICATOR, static_cast<ByteCounter>(end - ptr), ptr, end};
+        ptr = _parseChildren(block, scene.get(), decoders);
+    }
+
+    while (ptr + TVG_INDICATOR_SIZE + BYTE_COUNTER_SIZE <= end) {
         auto block = _readBlock(ptr);
         if (block.end > end) return nullptr;
         scene->push(unique_ptr<Paint>(_parsePaint(block)));
@@ -513,4 +856,14 @@ unique_ptr<Scene> tvgLoadData(const char *ptr, uint32_t size)
     }
 
     return move(scene);
-}
\ No newline at end of file
+}
+
+
+void tvgDecoderFree(TvgDecoder* decoder)
+{
+    while (decoder) {
+        auto prev = decoder->prev;
+        delete(decoder);
+        decoder = prev;
+    }
+}
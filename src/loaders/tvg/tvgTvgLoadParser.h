@@ -26,7 +26,11 @@
 #include "tvgCommon.h"
 #include "tvgBinaryDesc.h"
 
+struct TvgDecoder;
+
 bool tvgValidateData(const char *ptr, uint32_t size);
-unique_ptr<Scene> tvgLoadData(const char *ptr, uint32_t size);
+bool tvgReadViewbox(const char *ptr, uint32_t size, float* viewbox, bool* preserveAspect);
+unique_ptr<Scene> tvgLoadData(const char *ptr, uint32_t size, TvgDecoder** decoders);
+void tvgDecoderFree(TvgDecoder* decoder);
 
 #endif //_TVG_TVG_LOAD_PARSER_H_
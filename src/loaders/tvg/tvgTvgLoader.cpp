@@ -20,7 +20,6 @@
  * SOFTWARE.
  */
 
-#include <fstream>
 #include <memory.h>
 #include "tvgLoaderMgr.h"
 #include "tvgTvgLoader.h"
@@ -34,6 +33,7 @@
 void TvgLoader::clear()
 {
     if (copy) free((char*)data);
+    file.close();
     data = nullptr;
     pointer = nullptr;
     size = 0;
@@ -41,6 +41,24 @@ void TvgLoader::clear()
 }
 
 
+bool TvgLoader::header()
+{
+    if (!tvgValidateData(pointer, size)) return false;
+
+    //The view box of the source kept by the saver.
+    float viewbox[6];
+    if (tvgReadViewbox(pointer, size, viewbox, &preserveAspect)) {
+        vx = viewbox[0];
+        vy = viewbox[1];
+        vw = viewbox[2];
+        vh = viewbox[3];
+        w = viewbox[4];
+        h = viewbox[5];
+    }
+    return true;
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -55,34 +73,14 @@ bool TvgLoader::open(const string &path)
 {
     clear();
 
-    ifstream f;
-    f.open(path, ifstream::in | ifstream::binary | ifstream::ate);
-
-    if (!f.is_open()) return false;
-
-    size = f.tellg();
-    f.seekg(0, ifstream::beg);
-
-    copy = true;
-    data = (char*)malloc(size);
-    if (!data) {
-        clear();
-        f.close();
-        return false;
-    }
-
-    if (!f.read((char*)data, size))
-    {
-        clear();
-        f.close();
-        return false;
-    }
-
-    f.close();
+    //Decode over the file pages directly.
+    if (!file.open(path)) return false;
 
+    data = file.data;
+    size = file.size;
     pointer = data;
 
-    return tvgValidateData(pointer, size);
+    return header();
 }
 
 bool TvgLoader::open(const char *data, uint32_t size, bool copy)
@@ -99,7 +97,7 @@ bool TvgLoader::open(const char *data, uint32_t size, bool copy)
     this->size = size;
     this->copy = copy;
 
-    return tvgValidateData(pointer, size);
+    return header();
 }
 
 bool TvgLoader::read()
@@ -114,20 +112,30 @@ bool TvgLoader::read()
 bool TvgLoader::close()
 {
     this->done();
+    tvgDecoderFree(decoders);
+    decoders = nullptr;
     clear();
     return true;
 }
 
+void TvgLoader::wait()
+{
+    this->done();
+}
+
+
 void TvgLoader::run(unsigned tid)
 {
     if (root) root.reset();
-    root = tvgLoadData(pointer, size);
+    root = tvgLoadData(pointer, size, &decoders);
     if (!root) clear();
 }
 
 unique_ptr<Scene> TvgLoader::scene()
 {
     this->done();
-    if (root) return move(root);
-    return nullptr;
+    if (!root) return nullptr;
+    //The scene is kept for the other pictures sharing this loader.
+    if (cached) return unique_ptr<Scene>(static_cast<Scene*>(root->duplicate()));
+    return move(root);
 }
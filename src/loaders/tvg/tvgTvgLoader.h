@@ -24,15 +24,20 @@
 #define _TVG_TVG_LOADER_H_
 
 #include "tvgTaskScheduler.h"
+#include "tvgFileSource.h"
+
+struct TvgDecoder;
 
 class TvgLoader : public Loader, public Task
 {
 public:
+    FileSource file;
     const char* data = nullptr;
     const char* pointer = nullptr;
     uint32_t size = 0;
 
     unique_ptr<Scene> root = nullptr;
+    TvgDecoder* decoders = nullptr;     //decoding the large scenes in parallel
 
     bool copy = false;
 
@@ -43,12 +48,14 @@ public:
     bool open(const char *data, uint32_t size, bool copy) override;
     bool read() override;
     bool close() override;
+    void wait() override;
 
     void run(unsigned tid) override;
     unique_ptr<Scene> scene() override;
 
 private:
     void clear();
+    bool header();
 };
 
 #endif //_TVG_TVG_LOADER_H_
@@ -28,3 +28,14 @@ TEST_CASE("Basic capi initialization", "[capiInitializer]")
     REQUIRE(tvg_engine_init(TVG_ENGINE_SW, 0) == TVG_RESULT_SUCCESS);
     REQUIRE(tvg_engine_term(TVG_ENGINE_SW) == TVG_RESULT_SUCCESS);
 }
+
+TEST_CASE("Resource cache", "[capiInitializer]")
+{
+    REQUIRE(tvg_engine_cache(1024 * 1024) == TVG_RESULT_SUCCESS);
+    REQUIRE(tvg_engine_purge() == TVG_RESULT_SUCCESS);
+    REQUIRE(tvg_engine_cache(0) == TVG_RESULT_SUCCESS);
+
+    REQUIRE(tvg_engine_storage(nullptr) == TVG_RESULT_INVALID_ARGUMENT);
+    REQUIRE(tvg_engine_storage(".") == TVG_RESULT_SUCCESS);
+    REQUIRE(tvg_engine_storage("") == TVG_RESULT_SUCCESS);
+}
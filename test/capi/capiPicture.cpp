@@ -66,6 +66,17 @@ TEST_CASE("Load Svg Data in Picture", "[capiPicture]")
     REQUIRE(w == Approx(1000).epsilon(0.0000001));
     REQUIRE(h == Approx(1000).epsilon(0.0000001));
 
+    //Chunks
+    REQUIRE(tvg_picture_feed(nullptr, svg, 10) == TVG_RESULT_INVALID_ARGUMENT);
+    REQUIRE(tvg_picture_finish(nullptr) == TVG_RESULT_INVALID_ARGUMENT);
+    REQUIRE(tvg_picture_finish(picture) == TVG_RESULT_INSUFFICIENT_CONDITION);
+    REQUIRE(tvg_picture_feed(picture, svg, 10) == TVG_RESULT_SUCCESS);
+    REQUIRE(tvg_picture_feed(picture, svg + 10, 100) == TVG_RESULT_SUCCESS);
+    REQUIRE(tvg_picture_get_viewbox(picture, nullptr, nullptr, &w, &h) == TVG_RESULT_SUCCESS);
+    REQUIRE(w == Approx(1000).epsilon(0.0000001));
+    REQUIRE(tvg_picture_feed(picture, svg + 110, strlen(svg) - 110) == TVG_RESULT_SUCCESS);
+    REQUIRE(tvg_picture_finish(picture) == TVG_RESULT_SUCCESS);
+
     REQUIRE(tvg_paint_del(picture) == TVG_RESULT_SUCCESS);
 }
 
@@ -95,6 +106,14 @@ TEST_CASE("Load Raw file in Picture", "[capiPicture]")
         REQUIRE(tvg_picture_get_viewbox(picture, nullptr, nullptr, &w, &h) == TVG_RESULT_SUCCESS);
         REQUIRE(w == Approx(200).epsilon(0.0000001));
         REQUIRE(h == Approx(300).epsilon(0.0000001));
+
+        //Region
+        REQUIRE(tvg_picture_load_raw_region(nullptr, data, 200, 10, 20, 100, 100, false) == TVG_RESULT_INVALID_ARGUMENT);
+        REQUIRE(tvg_picture_load_raw_region(picture, data, 200, 150, 20, 100, 100, false) == TVG_RESULT_INVALID_ARGUMENT);
+        REQUIRE(tvg_picture_load_raw_region(picture, data, 200, 10, 20, 100, 100, false) == TVG_RESULT_SUCCESS);
+        REQUIRE(tvg_picture_get_viewbox(picture, nullptr, nullptr, &w, &h) == TVG_RESULT_SUCCESS);
+        REQUIRE(w == Approx(100).epsilon(0.0000001));
+        REQUIRE(h == Approx(100).epsilon(0.0000001));
     }
 
     REQUIRE(tvg_paint_del(picture) == TVG_RESULT_SUCCESS);
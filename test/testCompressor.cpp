@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include "catch.hpp"
+#include "tvgCompressor.h"
+
+using namespace tvg;
+using namespace std;
+
+TEST_CASE("Compress and decompress the data", "[tvgCompressor]")
+{
+    uint32_t seed = 1;
+    auto next = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<char>(seed >> 16); };
+
+    //Empty, short, repeated over the window and incompressible ones.
+    vector<string> sources = {"", "a", "abcdabcdabcd", string(100, 'x')};
+    string source;
+    for (int i = 0; i < 100000; ++i) source += "Repeated " + to_string(i % 3000) + ";";
+    sources.push_back(source);
+    source.clear();
+    for (int i = 0; i < 10000; ++i) source += next();
+    sources.push_back(source);
+
+    for (auto& src : sources) {
+        auto size = static_cast<uint32_t>(src.size());
+        vector<char> compressed(lz4Bound(size));
+        REQUIRE(lz4Compress(src.data(), size, compressed.data(), lz4Bound(size) - 1) == 0);
+        auto compressedSize = lz4Compress(src.data(), size, compressed.data(), lz4Bound(size));
+        REQUIRE(compressedSize > 0);
+        REQUIRE(compressedSize <= lz4Bound(size));
+
+        vector<char> decompressed(size + 1);
+        REQUIRE(lz4Decompress(compressed.data(), compressedSize, decompressed.data(), size));
+        REQUIRE(!memcmp(decompressed.data(), src.data(), size));
+
+        //Neither the shorter nor the longer destination is filled exactly.
+        if (size > 0) REQUIRE(!lz4Decompress(compressed.data(), compressedSize, decompressed.data(), size - 1));
+        REQUIRE(!lz4Decompress(compressed.data(), compressedSize, decompressed.data(), size + 1));
+    }
+
+    //The repeated one is well compressed.
+    vector<char> compressed(lz4Bound(sources[4].size()));
+    REQUIRE(lz4Compress(sources[4].data(), sources[4].size(), compressed.data(), compressed.size()) < sources[4].size() / 4);
+}
+
+TEST_CASE("Decompress the malformed data", "[tvgCompressor]")
+{
+    string src;
+    for (int i = 0; i < 2000; ++i) src += "Repeated " + to_string(i % 300) + ";";
+    auto size = static_cast<uint32_t>(src.size());
+    vector<char> compressed(lz4Bound(size));
+    auto compressedSize = lz4Compress(src.data(), size, compressed.data(), lz4Bound(size));
+    vector<char> dst(size);
+
+    //Truncated anywhere.
+    for (uint32_t i = 0; i < compressedSize; ++i) {
+        REQUIRE(!lz4Decompress(compressed.data(), i, dst.data(), size));
+    }
+
+    //Corrupted anywhere, not overrunning the destination.
+    for (uint32_t i = 0; i < compressedSize; ++i) {
+        auto corrupted = compressed;
+        corrupted[i] ^= 0xff;
+        lz4Decompress(corrupted.data(), compressedSize, dst.data(), size);
+    }
+
+    //The references out of the data decompressed, the lengths over the destination.
+    const char zeroOffset[] = {0x10, 'a', 0x00, 0x00, 0x10, 'a'};
+    REQUIRE(!lz4Decompress(zeroOffset, sizeof(zeroOffset), dst.data(), 6));
+    const char farOffset[] = {0x10, 'a', 0x02, 0x00, 0x10, 'a'};
+    REQUIRE(!lz4Decompress(farOffset, sizeof(farOffset), dst.data(), 6));
+    const char nearOffset[] = {0x10, 'a', 0x01, 0x00, 0x10, 'a'};
+    REQUIRE(lz4Decompress(nearOffset, sizeof(nearOffset), dst.data(), 6));
+    REQUIRE(!memcmp(dst.data(), "aaaaaa", 6));
+    const char longLiterals[] = {static_cast<char>(0xf0), static_cast<char>(0xff), static_cast<char>(0xff), 0x00, 'a'};
+    REQUIRE(!lz4Decompress(longLiterals, sizeof(longLiterals), dst.data(), size));
+    const char longMatch[] = {0x1f, 'a', 0x01, 0x00, static_cast<char>(0xff), static_cast<char>(0xff), 0x00, 0x10, 'a'};
+    REQUIRE(!lz4Decompress(longMatch, sizeof(longMatch), dst.data(), 100));
+}
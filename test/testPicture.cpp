@@ -22,12 +22,44 @@
 
 #include <thorvg.h>
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <dirent.h>
+#include <unistd.h>
 #include <fstream>
+#include <vector>
+#include <thread>
 #include "catch.hpp"
 
 using namespace tvg;
 using namespace std;
 
+//A new empty directory for the files written by a test
+static string _tempDir()
+{
+    char dir[] = P_tmpdir "/tvgXXXXXX";
+    if (!mkdtemp(dir)) return "";
+    return dir;
+}
+
+static vector<string> _files(const string& dir)
+{
+    vector<string> files;
+    auto d = opendir(dir.c_str());
+    if (!d) return files;
+    while (auto entry = readdir(d)) {
+        if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..")) files.push_back(dir + "/" + entry->d_name);
+    }
+    closedir(d);
+    return files;
+}
+
+static void _removeDir(const string& dir)
+{
+    for (auto& file : _files(dir)) remove(file.c_str());
+    rmdir(dir.c_str());
+}
+
 TEST_CASE("Load SVG file", "[tvgPicture]")
 {
     auto picture = Picture::gen();
@@ -43,6 +75,29 @@ TEST_CASE("Load SVG file", "[tvgPicture]")
     REQUIRE(picture->size(&w, &h) == Result::Success);
 }
 
+TEST_CASE("Build the SVG file by the workers", "[tvgPicture]")
+{
+    //The leaf shapes are built in batches by the workers, drawn the same as by the loading thread alone.
+    static uint32_t buffer[2][200*200];
+    uint32_t threads[2] = {0, 4};
+    for (int i = 0; i < 2; ++i) {
+        REQUIRE(Initializer::init(CanvasEngine::Sw, threads[i]) == Result::Success);
+        auto canvas = SwCanvas::gen();
+        memset(buffer[i], 0, sizeof(buffer[i]));
+        REQUIRE(canvas->target(buffer[i], 200, 200, 200, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(TEST_DIR"/tiger.svg") == Result::Success);
+        REQUIRE(picture->size(200, 200) == Result::Success);
+        REQUIRE(canvas->push(move(picture)) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        canvas.reset();
+        REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+    }
+    REQUIRE(buffer[0][100 * 200 + 100] != 0);
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+}
+
 TEST_CASE("Load SVG Data", "[tvgPicture]")
 {
     static const char* svg = "<svg height=\"1000\" viewBox=\"0 0 1000 1000\" width=\"1000\" xmlns=\"http://www.w3.org/2000/svg\"><path d=\"M.10681413.09784845 1000.0527.01592069V1000.0851L.06005738 999.9983Z\" fill=\"#ffffff\" stroke-width=\"3.910218\"/><g fill=\"#252f35\"><g stroke-width=\"3.864492\"><path d=\"M256.61221 100.51736H752.8963V386.99554H256.61221Z\"/><path d=\"M201.875 100.51736H238.366478V386.99554H201.875Z\"/><path d=\"M771.14203 100.51736H807.633508V386.99554H771.14203Z\"/></g><path d=\"M420.82388 380H588.68467V422.805317H420.82388Z\" stroke-width=\"3.227\"/><path d=\"m420.82403 440.7101v63.94623l167.86079 25.5782V440.7101Z\"/><path d=\"M420.82403 523.07258V673.47362L588.68482 612.59701V548.13942Z\"/></g><g fill=\"#222f35\"><path d=\"M420.82403 691.37851 588.68482 630.5019 589 834H421Z\"/><path d=\"m420.82403 852.52249h167.86079v28.64782H420.82403v-28.64782 0 0\"/><path d=\"m439.06977 879.17031c0 0-14.90282 8.49429-18.24574 15.8161-4.3792 9.59153 0 31.63185 0 31.63185h167.86079c0 0 4.3792-22.04032 0-31.63185-3.34292-7.32181-18.24574-15.8161-18.24574-15.8161z\"/></g><g fill=\"#ffffff\"><path d=\"m280 140h15v55l8 10 8-10v-55h15v60l-23 25-23-25z\"/><path d=\"m335 140v80h45v-50h-25v10h10v30h-15v-57h18v-13z\"/></g></svg>";
@@ -63,6 +118,55 @@ TEST_CASE("Load SVG Data", "[tvgPicture]")
     REQUIRE(h == 1000);
 }
 
+TEST_CASE("Load SVG Data in chunks", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    ifstream file(TEST_DIR"/tag.svg");
+    REQUIRE(file.is_open());
+    string svg((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    auto picture = Picture::gen();
+    REQUIRE(picture);
+
+    //Negative cases
+    REQUIRE(picture->finish() == Result::InsufficientCondition);
+    REQUIRE(picture->feed(nullptr, 100) == Result::InvalidArguments);
+    REQUIRE(picture->feed(svg.c_str(), 0) == Result::InvalidArguments);
+
+    //Cut the tags at any position
+    const uint32_t chunk = 7;
+    float w, h;
+    for (uint32_t i = 0; i < svg.size(); i += chunk) {
+        auto size = (svg.size() - i < chunk) ? (svg.size() - i) : chunk;
+        REQUIRE(picture->feed(svg.c_str() + i, size) == Result::Success);
+    }
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+    REQUIRE(w > 0);
+    REQUIRE(h > 0);
+    REQUIRE(picture->finish() == Result::Success);
+
+    //Same drawing as the whole data
+    auto whole = Picture::gen();
+    REQUIRE(whole);
+    REQUIRE(whole->load(svg.c_str(), svg.size(), true) == Result::Success);
+
+    uint32_t buffer[2][100*100];
+    unique_ptr<Picture> pictures[2] = {move(picture), move(whole)};
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas);
+        REQUIRE(canvas->target(buffer[i], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        REQUIRE(pictures[i]->size(100, 100) == Result::Success);
+        REQUIRE(canvas->push(move(pictures[i])) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
 TEST_CASE("Load RAW Data", "[tvgPicture]")
 {
     auto picture = Picture::gen();
@@ -92,6 +196,19 @@ TEST_CASE("Load RAW Data", "[tvgPicture]")
     REQUIRE(w == 200);
     REQUIRE(h == 300);
 
+    //Region of the data
+    REQUIRE(picture->load(data, 200, 150, 0, 100, 300, false) == Result::InvalidArguments);
+    REQUIRE(picture->load(data, 200, 150, 0, 0xffffffff, 300, false) == Result::InvalidArguments);
+    REQUIRE(picture->load(data, 200, 50, 100, 100, 150, false) == Result::Success);
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+    REQUIRE(w == 100);
+    REQUIRE(h == 150);
+    REQUIRE(picture->data() == data + 100 * 200 + 50);
+
+    REQUIRE(picture->load(data, 200, 50, 100, 100, 150, true) == Result::Success);
+    REQUIRE(picture->data()[0] == data[100 * 200 + 50]);
+    REQUIRE(picture->data()[100] == data[101 * 200 + 50]);
+
     free(data);
 }
 
@@ -110,6 +227,9 @@ TEST_CASE("Load PNG file from path", "[tvgPicture]")
 
     REQUIRE(w == 1000);
     REQUIRE(h == 1000);
+
+    //Decoded in place without the scheduler
+    REQUIRE(picture->data());
 }
 
 TEST_CASE("Load PNG file from data", "[tvgPicture]")
@@ -133,6 +253,12 @@ TEST_CASE("Load PNG file from data", "[tvgPicture]")
     REQUIRE(w == 1000);
     REQUIRE(h == 1000);
 
+    //The png signature without the image
+    REQUIRE(picture->load(data, 8, false) == Result::NonSupport);
+
+    //The header without the whole pixels
+    REQUIRE(picture->load(data, 1024, false) == Result::Unknown);
+
     free(data);
 }
 
@@ -233,8 +359,803 @@ TEST_CASE("Load PNG file and render", "[tvgPicture]")
 
     REQUIRE(picture->load(TEST_DIR"/logo.png") == Result::Success);
 
+    auto pixels = picture->data();
+    float w, h;
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+
+    //Decoded pixels are premultiplied
+    REQUIRE(pixels);
+    auto premultiplied = true;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(w * h); ++i) {
+        auto a = pixels[i] >> 24;
+        if (((pixels[i] >> 16) & 0xff) > a || ((pixels[i] >> 8) & 0xff) > a || (pixels[i] & 0xff) > a) premultiplied = false;
+    }
+    REQUIRE(premultiplied);
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Load PNG file into the size", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    auto canvas = SwCanvas::gen();
+    REQUIRE(canvas);
+
+    uint32_t buffer[100*100];
+    memset(buffer, 0, sizeof(buffer));
+    REQUIRE(canvas->target(buffer, 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+
+    auto picture = Picture::gen();
+    REQUIRE(picture);
+
+    //The size given in advance is kept, the image is drawn in its own size
+    REQUIRE(picture->size(100, 100) == Result::Success);
+    REQUIRE(picture->load(TEST_DIR"/logo.png") == Result::Success);
+
+    float w, h;
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+    REQUIRE(w == 100);
+    REQUIRE(h == 100);
+
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+
+    //Same as the image not sized
+    uint32_t reference[100*100];
+    memset(reference, 0, sizeof(reference));
+    auto canvas2 = SwCanvas::gen();
+    REQUIRE(canvas2->target(reference, 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+    auto picture2 = Picture::gen();
+    REQUIRE(picture2->load(TEST_DIR"/logo.png") == Result::Success);
+    REQUIRE(canvas2->push(move(picture2)) == Result::Success);
+    REQUIRE(canvas2->draw() == Result::Success);
+    REQUIRE(canvas2->sync() == Result::Success);
+
+    REQUIRE(buffer[50 * 100 + 50] != 0);
+    REQUIRE(!memcmp(buffer, reference, sizeof(buffer)));
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Stream the large PNG file", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    //Colored by the quadrants, split at the 2048th column and row of 4100x4100 pixels.
+    ifstream file(TEST_DIR"/large.png", ios::in | ios::binary);
+    REQUIRE(file.is_open());
+    string png((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        uint32_t buffer[100*100];
+        memset(buffer, 0, sizeof(buffer));
+        REQUIRE(canvas->target(buffer, 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+
+        auto picture = Picture::gen();
+        if (i == 0) REQUIRE(picture->load(TEST_DIR"/large.png") == Result::Success);
+        else REQUIRE(picture->load(png.c_str(), png.size(), true) == Result::Success);
+
+        float w, h;
+        REQUIRE(picture->size(&w, &h) == Result::Success);
+        REQUIRE(w == 4100);
+        REQUIRE(h == 4100);
+
+        //Too large to be decoded as a whole
+        REQUIRE(!picture->data());
+
+        //The visible region around the center
+        REQUIRE(picture->translate(-2000, -2000) == Result::Success);
+        auto p = picture.get();
+        REQUIRE(canvas->push(move(picture)) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        REQUIRE(buffer[10 * 100 + 10] == 0xff0000ff);
+        REQUIRE(buffer[10 * 100 + 90] == 0xff00ff00);
+        REQUIRE(buffer[90 * 100 + 10] == 0xffff0000);
+        REQUIRE(buffer[90 * 100 + 90] == 0xffffffff);
+
+        //The whole image sampled down into the canvas
+        memset(buffer, 0, sizeof(buffer));
+        REQUIRE(p->translate(0, 0) == Result::Success);
+        REQUIRE(p->scale(100.0f / 4100.0f) == Result::Success);
+        REQUIRE(canvas->update(p) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        REQUIRE(buffer[25 * 100 + 25] == 0xff0000ff);
+        REQUIRE(buffer[25 * 100 + 75] == 0xff00ff00);
+        REQUIRE(buffer[75 * 100 + 25] == 0xffff0000);
+        REQUIRE(buffer[75 * 100 + 75] == 0xffffffff);
+    }
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Stream the large PNG file in its gamma", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    //The same linear gray, decoded as a whole and streamed, is corrected the same into sRGB.
+    uint32_t colors[2];
+    const char* paths[] = {TEST_DIR"/gamma.png", TEST_DIR"/gamma_large.png"};
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        uint32_t buffer[10*10];
+        memset(buffer, 0, sizeof(buffer));
+        REQUIRE(canvas->target(buffer, 10, 10, 10, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(paths[i]) == Result::Success);
+        REQUIRE(canvas->push(move(picture)) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        colors[i] = buffer[5 * 10 + 5];
+    }
+    REQUIRE(colors[0] == colors[1]);
+    REQUIRE(colors[0] != 0xff808080);
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Draw the duplicated PNG file in the other colorspaces", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    auto picture = Picture::gen();
+    REQUIRE(picture->load(TEST_DIR"/logo.png") == Result::Success);
+    REQUIRE(picture->size(100, 100) == Result::Success);
+    auto duplicate = unique_ptr<Picture>(static_cast<Picture*>(picture->duplicate()));
+    REQUIRE(duplicate);
+
+    uint32_t abgr[100*100], argb[100*100], again[100*100];
+    memset(abgr, 0, sizeof(abgr));
+    memset(argb, 0, sizeof(argb));
+
+    auto canvas = SwCanvas::gen();
+    REQUIRE(canvas->target(abgr, 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+    memcpy(again, abgr, sizeof(again));
+
+    auto canvas2 = SwCanvas::gen();
+    REQUIRE(canvas2->target(argb, 100, 100, 100, SwCanvas::Colorspace::ARGB8888) == Result::Success);
+    REQUIRE(canvas2->push(move(duplicate)) == Result::Success);
+    REQUIRE(canvas2->draw() == Result::Success);
+    REQUIRE(canvas2->sync() == Result::Success);
+
+    //The pixels are shared by the pictures, but arranged for each target.
+    uint32_t swapped = 0;
+    for (uint32_t i = 0; i < 100 * 100; ++i) {
+        auto c = argb[i];
+        if (abgr[i] != ((c & 0xff00ff00) | ((c & 0x00ff0000) >> 16) | ((c & 0x000000ff) << 16))) ++swapped;
+    }
+    REQUIRE(swapped == 0);
+    REQUIRE(abgr[50 * 100 + 50] != 0);
+
+    //Drawn again as it was, the other target left the pixels alone.
+    memset(abgr, 0, sizeof(abgr));
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+    REQUIRE(!memcmp(abgr, again, sizeof(abgr)));
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Load PNG files in parallel", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 4) == Result::Success);
+
+    ifstream file(TEST_DIR"/logo.png", ios::in | ios::binary);
+    REQUIRE(file.is_open());
+    string png((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    //The decoding goes on the workers, the copied data can be released after loading.
+    Picture* pictures[8];
+    for (int i = 0; i < 8; ++i) {
+        auto data = (char*)malloc(png.size());
+        memcpy(data, png.c_str(), png.size());
+        pictures[i] = Picture::gen().release();
+        REQUIRE(pictures[i]->load(data, png.size(), true) == Result::Success);
+        free(data);
+    }
+
+    const uint32_t* pixels = nullptr;
+    float w, h;
+    for (int i = 0; i < 8; ++i) {
+        REQUIRE(pictures[i]->size(&w, &h) == Result::Success);
+        auto data = pictures[i]->data();
+        REQUIRE(data);
+        if (pixels) REQUIRE(!memcmp(pixels, data, sizeof(uint32_t) * static_cast<uint32_t>(w * h)));
+        else pixels = data;
+    }
+    for (int i = 0; i < 8; ++i) delete(pictures[i]);
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Share the resources through the cache", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+    REQUIRE(Initializer::cache(16 * 1024 * 1024) == Result::Success);
+
+    //Same file, cached once it is decoded
+    auto picture = Picture::gen();
+    auto picture2 = Picture::gen();
+    REQUIRE(picture->load(TEST_DIR"/logo.png") == Result::Success);
+    REQUIRE(picture->data());
+    REQUIRE(picture2->load(TEST_DIR"/../images/logo.png") == Result::Success);
+    REQUIRE(picture->data() == picture2->data());
+
+    //Same data
+    ifstream file(TEST_DIR"/logo.png", ios::in | ios::binary);
+    REQUIRE(file.is_open());
+    string png((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    auto picture3 = Picture::gen();
+    auto picture4 = Picture::gen();
+    REQUIRE(picture3->load(png.c_str(), png.size(), true) == Result::Success);
+    REQUIRE(picture3->data());
+    REQUIRE(picture4->load(png.c_str(), png.size(), true) == Result::Success);
+    REQUIRE(picture3->data() == picture4->data());
+
+    //Not the same data of the same size
+    string other = png;
+    other[other.size() - 1] ^= 0xff;
+    auto picture7 = Picture::gen();
+    REQUIRE(picture7->load(other.c_str(), other.size(), true) == Result::Success);
+    REQUIRE(picture7->data() != picture3->data());
+
+    //Each picture takes its own copy of the scene
+    uint32_t buffer[2][100*100];
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas->target(buffer[i], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        auto svg = Picture::gen();
+        REQUIRE(svg->load(TEST_DIR"/tag.svg") == Result::Success);
+        REQUIRE(svg->size(100, 100) == Result::Success);
+        REQUIRE(canvas->push(move(svg)) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    //Loaded again after purging
+    REQUIRE(Initializer::purge() == Result::Success);
+    auto picture5 = Picture::gen();
+    REQUIRE(picture5->load(TEST_DIR"/logo.png") == Result::Success);
+    REQUIRE(picture5->data() != picture->data());
+
+    //Out of the budget
+    REQUIRE(Initializer::cache(1024) == Result::Success);
+    auto picture6 = Picture::gen();
+    REQUIRE(picture6->load(TEST_DIR"/logo.png") == Result::Success);
+    REQUIRE(picture6->data() != picture5->data());
+
+    REQUIRE(Initializer::cache(0) == Result::Success);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Draw the cached PNG file in the other colorspaces", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 4) == Result::Success);
+    REQUIRE(Initializer::cache(16 * 1024 * 1024) == Result::Success);
+
+    //The pictures of the same file share the loader through the cache, once the first one is drawn.
+    uint32_t buffer[2][100*100];
+    SwCanvas::Colorspace cs[2] = {SwCanvas::Colorspace::ABGR8888, SwCanvas::Colorspace::ARGB8888};
+    unique_ptr<SwCanvas> canvas[2];
+    const uint32_t* shared[2];
+    for (int i = 0; i < 2; ++i) {
+        memset(buffer[i], 0, sizeof(buffer[i]));
+        canvas[i] = SwCanvas::gen();
+        REQUIRE(canvas[i]->target(buffer[i], 100, 100, 100, cs[i]) == Result::Success);
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(TEST_DIR"/logo.png") == Result::Success);
+        REQUIRE(picture->size(100, 100) == Result::Success);
+        shared[i] = picture->data();
+        REQUIRE(canvas[i]->push(move(picture)) == Result::Success);
+        REQUIRE(canvas[i]->draw() == Result::Success);
+        REQUIRE(canvas[i]->sync() == Result::Success);
+    }
+    REQUIRE(shared[0] == shared[1]);
+
+    uint32_t swapped = 0;
+    for (uint32_t i = 0; i < 100 * 100; ++i) {
+        auto c = buffer[1][i];
+        if (buffer[0][i] != ((c & 0xff00ff00) | ((c & 0x00ff0000) >> 16) | ((c & 0x000000ff) << 16))) ++swapped;
+    }
+    REQUIRE(swapped == 0);
+    REQUIRE(buffer[0][50 * 100 + 50] != 0);
+
+    canvas[0].reset();
+    canvas[1].reset();
+    REQUIRE(Initializer::cache(0) == Result::Success);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Draw the cached loader in the threads", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 4) == Result::Success);
+    REQUIRE(Initializer::cache(16 * 1024 * 1024) == Result::Success);
+
+    //Each thread draws the pictures of the same files, shared through the cache after the first one.
+    static const char* paths[2] = {TEST_DIR"/tag.svg", TEST_DIR"/logo.png"};
+    auto draw = [](uint32_t* buffer, const char* path) {
+        auto canvas = SwCanvas::gen();
+        if (canvas->target(buffer, 100, 100, 100, SwCanvas::Colorspace::ABGR8888) != Result::Success) return false;
+        auto picture = Picture::gen();
+        if (picture->load(path) != Result::Success) return false;
+        if (picture->size(100, 100) != Result::Success) return false;
+        if (canvas->push(move(picture)) != Result::Success) return false;
+        if (canvas->draw() != Result::Success) return false;
+        return canvas->sync() == Result::Success;
+    };
+
+    vector<uint32_t> expected[2];
+    for (int i = 0; i < 2; ++i) {
+        expected[i].resize(100 * 100);
+        REQUIRE(draw(expected[i].data(), paths[i]));
+    }
+
+    bool passed[4] = {false, false, false, false};
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            vector<uint32_t> buffer(100 * 100);
+            for (int n = 0; n < 8; ++n) {
+                auto i = (t + n) % 2;
+                fill(buffer.begin(), buffer.end(), 0);
+                if (!draw(buffer.data(), paths[i]) || buffer != expected[i]) return;
+            }
+            passed[t] = true;
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int t = 0; t < 4; ++t) REQUIRE(passed[t]);
+
+    REQUIRE(Initializer::cache(0) == Result::Success);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Load SVG file through the compiled cache", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    auto dir = _tempDir();
+    REQUIRE(!dir.empty());
+    REQUIRE(Initializer::storage(TEST_DIR"/tag.svg") == Result::InvalidArguments);
+    REQUIRE(Initializer::storage(dir) == Result::Success);
+
+    //The first load compiles the scene, the next one reads it.
+    uint32_t buffer[2][100*100];
+    float w[2], h[2];
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas->target(buffer[i], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(TEST_DIR"/logo.svg") == Result::Success);
+        REQUIRE(picture->size(&w[i], &h[i]) == Result::Success);
+        REQUIRE(picture->size(100, 100) == Result::Success);
+        REQUIRE(canvas->push(move(picture)) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(w[0] == w[1]);
+    REQUIRE(h[0] == h[1]);
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    //Just the compiled file, without the temporary one
+    auto files = _files(dir);
+    REQUIRE(files.size() == 1);
+    REQUIRE(files[0].substr(files[0].size() - 4) == ".tvg");
+
+    //Replaced by another scene, the svg is not parsed but the file is read.
+    auto shape = Shape::gen();
+    REQUIRE(shape->appendRect(0, 0, 100, 100, 0, 0) == Result::Success);
+    REQUIRE(shape->fill(255, 0, 0, 255) == Result::Success);
+    auto saver = Saver::gen();
+    REQUIRE(saver->save(move(shape), files[0]) == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+
+    memset(buffer[0], 0, sizeof(buffer[0]));
+    auto canvas = SwCanvas::gen();
+    REQUIRE(canvas->target(buffer[0], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+    auto picture = Picture::gen();
+    REQUIRE(picture->load(TEST_DIR"/logo.svg") == Result::Success);
     REQUIRE(canvas->push(move(picture)) == Result::Success);
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+    REQUIRE(buffer[0][50 * 100 + 50] == 0xff0000ff);
+
+    REQUIRE(Initializer::storage("") == Result::Success);
+    _removeDir(dir);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Load the compiled SVG file by the workers", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 4) == Result::Success);
+    auto dir = _tempDir();
+    REQUIRE(!dir.empty());
+    REQUIRE(Initializer::storage(dir) == Result::Success);
+
+    //Thousands of curves at scattered points, large enough to share the decoding.
+    string svg = "<svg viewBox=\"0 0 1000 1000\" xmlns=\"http://www.w3.org/2000/svg\">";
+    uint32_t seed = 1;
+    auto next = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 8) % 100000 / 100.0f; };
+    char path[256];
+    for (int i = 0; i < 4000; ++i) {
+        snprintf(path, sizeof(path), "<path d=\"M%.2f %.2fC%.2f %.2f %.2f %.2f %.2f %.2fL%.2f %.2fZ\" fill=\"#%06x\"/>",
+                 next(), next(), next(), next(), next(), next(), next(), next(), next(), next(), seed & 0xffffff);
+        svg += path;
+    }
+    svg += "</svg>";
+
+    //The first load compiles the scene, the next one decodes it in parallel.
+    uint32_t buffer[2][100*100];
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas->target(buffer[i], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(svg.c_str(), svg.size(), true) == Result::Success);
+        REQUIRE(picture->size(100, 100) == Result::Success);
+        REQUIRE(canvas->push(move(picture)) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        if (i > 0) continue;
+        auto files = _files(dir);
+        REQUIRE(files.size() == 1);
+        ifstream file(files[0], ios::in | ios::binary | ios::ate);
+        REQUIRE(file.tellg() > 64 * 1024);
+    }
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    REQUIRE(Initializer::storage("") == Result::Success);
+    _removeDir(dir);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Save and load the paths in the fixed-point form", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+    auto dir = _tempDir();
+    REQUIRE(!dir.empty());
+    auto path = dir + "/path.tvg";
+
+    //The coordinates of a few decimal digits, and the ones of too many which are kept in the raw floats.
+    struct { float x, y; bool compact; } coords[] = {
+        {1.0f / 3, 2.0f / 3, false}, {12345.6f, -0.000001f, false},
+        {1, 7, true}, {0.5f, -12, true}, {100.25f, 3.125f, true}, {-1000.001f, 0.1f, true}
+    };
+
+    uint32_t raw = 0;
+    for (auto& coord : coords) {
+        //Many points of the same digits, the fixed-point form is smaller.
+        auto shape = Shape::gen();
+        REQUIRE(shape->moveTo(0, 0) == Result::Success);
+        for (int i = 0; i < 100; ++i) REQUIRE(shape->lineTo(coord.x + i, coord.y - i) == Result::Success);
+        REQUIRE(shape->close() == Result::Success);
+        float x, y, w, h;
+        REQUIRE(shape->bounds(&x, &y, &w, &h) == Result::Success);
+
+        auto saver = Saver::gen();
+        REQUIRE(saver->save(move(shape), path) == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+
+        ifstream file(path, ios::in | ios::binary | ios::ate);
+        auto size = static_cast<uint32_t>(file.tellg());
+        if (raw == 0) raw = size;
+        if (coord.compact) REQUIRE(size < raw / 2);
+        else REQUIRE(size == raw);
+
+        //Read back exactly
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(path) == Result::Success);
+        auto loaded = unique_ptr<Paint>(picture->duplicate());
+        float x2, y2, w2, h2;
+        REQUIRE(loaded->bounds(&x2, &y2, &w2, &h2) == Result::Success);
+        REQUIRE(x == x2);
+        REQUIRE(y == y2);
+        REQUIRE(w == w2);
+        REQUIRE(h == h2);
+    }
+
+    //The newer versions are not read.
+    ifstream file(path, ios::in | ios::binary);
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    REQUIRE(data.compare(0, 3, "TVG") == 0);
+    auto picture = Picture::gen();
+    REQUIRE(picture->load(data.c_str(), data.size(), true) == Result::Success);
+    data.replace(3, 3, "999");
+    REQUIRE(picture->load(data.c_str(), data.size(), true) == Result::NonSupport);
+
+    _removeDir(dir);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Save and load the compressed paints", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+    auto dir = _tempDir();
+    REQUIRE(!dir.empty());
+
+    //The same shape over again, compressed as a whole scene in the root one.
+    auto child = Scene::gen();
+    for (int i = 0; i < 500; ++i) {
+        auto shape = Shape::gen();
+        shape->moveTo(10.1f, 10.3f);
+        for (int j = 0; j < 10; ++j) shape->lineTo(10.1f + j * 8.7f, 90.3f - (j % 2) * 80.1f);
+        shape->close();
+        shape->fill(i % 256, 255 - i % 256, 128, 16);
+        child->push(move(shape));
+    }
+    auto scene = Scene::gen();
+    scene->push(move(child));
+
+    auto path = dir + "/compressed.tvg";
+    auto saver = Saver::gen();
+    REQUIRE(saver->save(unique_ptr<Paint>(scene->duplicate()), path) == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+
+    //Far less than the points alone.
+    ifstream file(path, ios::in | ios::binary);
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    REQUIRE(data.size() < 500 * 11 * 2 * sizeof(float) / 4);
+    auto metaLen = static_cast<uint8_t>(data[6]) | (static_cast<uint8_t>(data[7]) << 8);
+    //Past the indicator and the byte counter of the root.
+    REQUIRE(static_cast<uint8_t>(data[8 + metaLen + 5]) == 0x80);
+
+    uint32_t buffer[2][100*100];
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas->target(buffer[i], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        if (i == 0) {
+            REQUIRE(canvas->push(move(scene)) == Result::Success);
+        } else {
+            auto picture = Picture::gen();
+            REQUIRE(picture->load(path) == Result::Success);
+            REQUIRE(canvas->push(move(picture)) == Result::Success);
+        }
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    //Truncated or corrupted, the data is rejected or drawn without overrunning it.
+    for (uint32_t i = 0; i < data.size(); i += 7) {
+        for (int j = 0; j < 2; ++j) {
+            auto corrupted = data;
+            if (j == 0) corrupted.resize(i);
+            else corrupted[i] ^= 0x5a;
+            auto picture = Picture::gen();
+            if (picture->load(corrupted.c_str(), corrupted.size(), true) != Result::Success) continue;
+            auto canvas = SwCanvas::gen();
+            REQUIRE(canvas->target(buffer[1], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+            REQUIRE(canvas->push(move(picture)) == Result::Success);
+            canvas->draw();
+            canvas->sync();
+        }
+    }
+
+    _removeDir(dir);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Load the TVG scenes without an index by the workers", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 4) == Result::Success);
+    auto dir = _tempDir();
+    REQUIRE(!dir.empty());
+
+    //A few large scenes, too few to be indexed, found by the scan and shared by the workers.
+    uint32_t seed = 1;
+    auto next = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 8) % 100000 / 100.0f; };
+    auto scene = Scene::gen();
+    for (int i = 0; i < 6; ++i) {
+        auto child = Scene::gen();
+        for (int j = 0; j < 700; ++j) {
+            auto shape = Shape::gen();
+            shape->moveTo(next(), next());
+            shape->cubicTo(next(), next(), next(), next(), next(), next());
+            shape->lineTo(next(), next());
+            shape->close();
+            shape->fill(seed & 0xff, (seed >> 8) & 0xff, (seed >> 16) & 0xff, 255);
+            child->push(move(shape));
+        }
+        scene->push(move(child));
+    }
+    REQUIRE(scene->scale(0.1f) == Result::Success);
+
+    auto path = dir + "/scenes.tvg";
+    auto saver = Saver::gen();
+    REQUIRE(saver->save(unique_ptr<Paint>(scene->duplicate()), path) == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+
+    uint32_t buffer[2][100*100];
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas->target(buffer[i], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        if (i == 0) {
+            REQUIRE(canvas->push(move(scene)) == Result::Success);
+        } else {
+            auto picture = Picture::gen();
+            REQUIRE(picture->load(path) == Result::Success);
+            REQUIRE(canvas->push(move(picture)) == Result::Success);
+        }
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    _removeDir(dir);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
 
+TEST_CASE("Save and load the large nested scenes", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 4) == Result::Success);
+    auto dir = _tempDir();
+    REQUIRE(!dir.empty());
+
+    /* The children of the root go out to the file as the buffer fills up, the index and the byte counter
+       of the root are filled in the part written already, its own members follow the children. */
+    uint32_t seed = 1;
+    auto next = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 8) % 100000 / 1000.0f; };
+    auto scene = Scene::gen();
+    for (int i = 0; i < 24; ++i) {
+        auto child = Scene::gen();
+        for (int j = 0; j < 10; ++j) {
+            auto grandchild = Scene::gen();
+            for (int k = 0; k < 40; ++k) {
+                auto shape = Shape::gen();
+                shape->moveTo(next(), next());
+                shape->cubicTo(next(), next(), next(), next(), next(), next());
+                shape->close();
+                shape->fill(seed & 0xff, (seed >> 8) & 0xff, (seed >> 16) & 0xff, 128);
+                grandchild->push(move(shape));
+            }
+            child->push(move(grandchild));
+        }
+        child->opacity(128 + i * 5);
+        scene->push(move(child));
+    }
+    REQUIRE(scene->opacity(200) == Result::Success);
+    REQUIRE(scene->rotate(10) == Result::Success);
+
+    auto path = dir + "/nested.tvg";
+    auto saver = Saver::gen();
+    REQUIRE(saver->save(unique_ptr<Paint>(scene->duplicate()), path) == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+
+    //Many times the data of a child.
+    ifstream file(path, ios::in | ios::binary);
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    REQUIRE(data.size() > 24 * 10 * 40 * 8 * sizeof(float) / 2);
+
+    uint32_t buffer[2][100*100];
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas->target(buffer[i], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        if (i == 0) {
+            REQUIRE(canvas->push(move(scene)) == Result::Success);
+        } else {
+            auto picture = Picture::gen();
+            REQUIRE(picture->load(path) == Result::Success);
+            REQUIRE(canvas->push(move(picture)) == Result::Success);
+        }
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    //Saved aside, the file in the path is replaced as a whole.
+    REQUIRE(saver->save(Scene::gen(), path) == Result::Success);
+    REQUIRE(_files(dir).size() == 1);
+    ifstream replaced(path, ios::in | ios::binary);
+    REQUIRE(string((istreambuf_iterator<char>(replaced)), istreambuf_iterator<char>()).size() < 64);
+
+    _removeDir(dir);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Save and load the large picture of SVG", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+    auto dir = _tempDir();
+    REQUIRE(!dir.empty());
+
+    //The scene of the root picture goes out to the file in parts, the groups in it as well.
+    uint32_t seed = 1;
+    auto next = [&seed]() { seed = seed * 1103515245 + 12345; return to_string((seed >> 8) % 100000 / 1000.0f); };
+    string svg = "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 100 100\">";
+    for (int i = 0; i < 40; ++i) {
+        svg += "<g opacity=\"0.8\">";
+        for (int j = 0; j < 10; ++j) {
+            svg += "<g>";
+            for (int k = 0; k < 40; ++k) {
+                svg += "<path fill=\"#" + to_string(100000 + seed % 900000) + "\" fill-opacity=\"0.5\" d=\"M" + next() + " " + next();
+                svg += " C" + next() + " " + next() + " " + next() + " " + next() + " " + next() + " " + next() + " Z\"/>";
+            }
+            svg += "</g>";
+        }
+        svg += "</g>";
+    }
+    svg += "</svg>";
+
+    auto picture = Picture::gen();
+    REQUIRE(picture->load(svg.c_str(), svg.size(), true) == Result::Success);
+    REQUIRE(picture->size(100, 100) == Result::Success);
+
+    auto path = dir + "/picture.tvg";
+    auto saver = Saver::gen();
+    REQUIRE(saver->save(unique_ptr<Paint>(picture->duplicate()), path) == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+
+    //Over the buffer flushed at a time.
+    ifstream file(path, ios::in | ios::binary);
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    REQUIRE(data.size() > 512 * 1024);
+
+    uint32_t buffer[2][100*100];
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas->target(buffer[i], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        if (i == 0) {
+            REQUIRE(canvas->push(move(picture)) == Result::Success);
+        } else {
+            auto loaded = Picture::gen();
+            REQUIRE(loaded->load(path) == Result::Success);
+            REQUIRE(canvas->push(move(loaded)) == Result::Success);
+        }
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    _removeDir(dir);
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Duplicate the compiled SVG file", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+    auto dir = _tempDir();
+    REQUIRE(!dir.empty());
+    REQUIRE(Initializer::storage(dir) == Result::Success);
+
+    //The duplicate keeps the paths it shares after the original is gone.
+    uint32_t buffer[2][100*100];
+    for (int i = 0; i < 2; ++i) {
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas->target(buffer[i], 100, 100, 100, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(TEST_DIR"/tiger.svg") == Result::Success);
+        REQUIRE(picture->size(100, 100) == Result::Success);
+        if (i == 0) {
+            REQUIRE(canvas->push(move(picture)) == Result::Success);
+        } else {
+            auto dup = unique_ptr<Picture>(static_cast<Picture*>(picture->duplicate()));
+            REQUIRE(dup);
+            picture.reset();
+            REQUIRE(canvas->push(move(dup)) == Result::Success);
+        }
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    REQUIRE(_files(dir).size() == 1);
+    REQUIRE(Initializer::storage("") == Result::Success);
+    _removeDir(dir);
     REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
 }
 
@@ -257,3 +1178,238 @@ TEST_CASE("Load JPG file and render", "[tvgPicture]")
 
     REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
 }
+
+TEST_CASE("Load JPG file into the size", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    //The image is drawn in its own size, scaled down by the transform into the size hinted.
+    static uint32_t buffer[4][300*300];
+    auto draw = [](uint32_t* buffer, float size, bool ahead, float scale) {
+        memset(buffer, 0, sizeof(uint32_t) * 300 * 300);
+        auto canvas = SwCanvas::gen();
+        REQUIRE(canvas->target(buffer, 300, 300, 300, SwCanvas::Colorspace::ABGR8888) == Result::Success);
+        auto picture = Picture::gen();
+        if (ahead) REQUIRE(picture->size(size, size) == Result::Success);
+        REQUIRE(picture->load(TEST_DIR"/logo.jpg") == Result::Success);
+        if (!ahead) REQUIRE(picture->size(size, size) == Result::Success);
+        REQUIRE(picture->scale(scale) == Result::Success);
+        REQUIRE(canvas->push(move(picture)) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    };
+
+    //1000x1000 pixels into 100: decoded in 1/8 of the size, the same as into 125.
+    draw(buffer[0], 100, true, 0.1f);
+    draw(buffer[1], 125, true, 0.1f);
+    REQUIRE(buffer[0][50 * 300 + 50] != 0);
+    REQUIRE(buffer[0][150 * 300 + 150] == 0);
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+
+    //Into 300: decoded in 1/2 of the size, 1/4 doesn't cover it.
+    draw(buffer[0], 300, true, 0.3f);
+    draw(buffer[1], 500, true, 0.3f);
+    draw(buffer[2], 250, true, 0.3f);
+    REQUIRE(!memcmp(buffer[0], buffer[1], sizeof(buffer[0])));
+    REQUIRE(memcmp(buffer[0], buffer[2], sizeof(buffer[0])));
+
+    //Sized after loading: decoded in the full size.
+    draw(buffer[2], 300, false, 0.3f);
+    draw(buffer[3], 1000, true, 0.3f);
+    REQUIRE(!memcmp(buffer[2], buffer[3], sizeof(buffer[2])));
+
+    //The reduced decoding stays close to the full one.
+    uint32_t diff = 0;
+    for (uint32_t i = 0; i < 300 * 300; ++i) {
+        for (uint32_t c = 0; c < 32; c += 8) {
+            auto a = (buffer[0][i] >> c) & 0xff;
+            auto b = (buffer[2][i] >> c) & 0xff;
+            diff += a > b ? a - b : b - a;
+        }
+    }
+    REQUIRE(diff / (300 * 300 * 4) < 8);
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Load RAW file and render", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    auto canvas = SwCanvas::gen();
+    REQUIRE(canvas);
+
+    uint32_t buffer[100*100];
+    REQUIRE(canvas->target(buffer, 100, 100, 100, SwCanvas::Colorspace::ARGB8888) == Result::Success);
+
+    string path(TEST_DIR"/rawimage_200x300.raw");
+
+    ifstream file(path);
+    if (!file.is_open()) return;
+    auto data = (uint32_t*)malloc(sizeof(uint32_t) * (200*300));
+    file.read(reinterpret_cast<char *>(data), sizeof (uint32_t) * 200 * 300);
+    file.close();
+
+    //Shifted
+    auto picture = Picture::gen();
+    REQUIRE(picture);
+    REQUIRE(picture->load(data, 200, 300, false) == Result::Success);
+    REQUIRE(picture->translate(-50, -100) == Result::Success);
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 100; ++x) REQUIRE(buffer[y * 100 + x] == data[(y + 100) * 200 + (x + 50)]);
+    }
+    REQUIRE(canvas->clear() == Result::Success);
+
+    //Scaled
+    picture = Picture::gen();
+    REQUIRE(picture);
+    REQUIRE(picture->load(data, 200, 300, false) == Result::Success);
+    REQUIRE(picture->scale(0.5f) == Result::Success);
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 100; ++x) REQUIRE(buffer[y * 100 + x] == data[(y * 2) * 200 + (x * 2)]);
+    }
+    REQUIRE(canvas->clear() == Result::Success);
+
+    //Rotated
+    picture = Picture::gen();
+    REQUIRE(picture);
+    REQUIRE(picture->load(data, 200, 300, false) == Result::Success);
+    REQUIRE(picture->rotate(90) == Result::Success);
+    REQUIRE(picture->translate(100, 0) == Result::Success);
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 100; ++x) REQUIRE(buffer[y * 100 + x] == data[(100 - x) * 200 + y]);
+    }
+    REQUIRE(canvas->clear() == Result::Success);
+
+    //Region of the data
+    picture = Picture::gen();
+    REQUIRE(picture);
+    REQUIRE(picture->load(data, 200, 20, 30, 50, 50, false) == Result::Success);
+    REQUIRE(picture->translate(10, 10) == Result::Success);
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 100; ++x) {
+            auto inside = (x >= 10 && x < 60 && y >= 10 && y < 60);
+            REQUIRE(buffer[y * 100 + x] == (inside ? data[(y + 20) * 200 + (x + 10)] : 0));
+        }
+    }
+
+    free(data);
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Load compact RAW data and render", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    auto canvas = SwCanvas::gen();
+    REQUIRE(canvas);
+
+    uint32_t buffer[100*100] = {0};
+    REQUIRE(canvas->target(buffer, 100, 100, 100, SwCanvas::Colorspace::ARGB8888) == Result::Success);
+
+    uint8_t alpha[10*10];
+    memset(alpha, 0xff, sizeof(alpha));
+    uint8_t gray[10*10];
+    memset(gray, 0x80, sizeof(gray));
+    uint16_t color[10*10];
+    for (int i = 0; i < 10*10; ++i) color[i] = 0xf800;
+
+    auto picture = Picture::gen();
+    REQUIRE(picture);
+
+    //Invalid Arguments
+    REQUIRE(picture->load(nullptr, Picture::A8, 10, 10, 10, false) == Result::InvalidArguments);
+    REQUIRE(picture->load(alpha, Picture::A8, 10, 10, 5, false) == Result::InvalidArguments);
+
+    //A8 painted with the tint color
+    REQUIRE(picture->load(alpha, Picture::A8, 10, 10, 10, false) == Result::Success);
+    REQUIRE(picture->tint(0, 0, 255) == Result::Success);
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+
+    //L8
+    picture = Picture::gen();
+    REQUIRE(picture);
+    REQUIRE(picture->load(gray, Picture::L8, 10, 10, 10, true) == Result::Success);
+    REQUIRE(picture->translate(20, 0) == Result::Success);
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+
+    //RGB565, scaled
+    picture = Picture::gen();
+    REQUIRE(picture);
+    REQUIRE(picture->load(color, Picture::RGB565, 10, 10, 10, false) == Result::Success);
+    REQUIRE(picture->translate(40, 0) == Result::Success);
+    REQUIRE(picture->scale(2.0f) == Result::Success);
+    REQUIRE(canvas->push(move(picture)) == Result::Success);
+
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+
+    REQUIRE(buffer[5 * 100 + 5] == 0xff0000ff);
+    REQUIRE(buffer[5 * 100 + 25] == 0xff808080);
+    REQUIRE(buffer[15 * 100 + 55] == 0xffff0000);
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Get the compact pixels", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    //The grayscale file is kept in 8 bits, the data() is 32-bit still.
+    auto picture = Picture::gen();
+    REQUIRE(picture);
+    REQUIRE(picture->load(TEST_DIR"/gray.png") == Result::Success);
+
+    uint32_t w, h, stride;
+    Picture::PixelFormat format;
+    auto gray = static_cast<const uint8_t*>(picture->data(&w, &h, &stride, &format));
+    REQUIRE(gray);
+    REQUIRE(w == 16);
+    REQUIRE(h == 16);
+    REQUIRE(stride >= 16);
+    REQUIRE(format == Picture::L8);
+
+    auto pixels = picture->data();
+    REQUIRE(pixels);
+    for (uint32_t y = 0; y < h; ++y) {
+        for (uint32_t x = 0; x < w; ++x) {
+            uint32_t l = (x * 16 + y) & 0xff;
+            REQUIRE(gray[y * stride + x] == l);
+            REQUIRE(pixels[y * w + x] == (0xff000000 | (l << 16) | (l << 8) | l));
+        }
+    }
+
+    //The raw ones, in the given layout.
+    uint16_t color[4*2];
+    for (int i = 0; i < 4*2; ++i) color[i] = 0x07e0;
+    picture = Picture::gen();
+    REQUIRE(picture);
+    REQUIRE(picture->load(color, Picture::RGB565, 3, 2, 4, false) == Result::Success);
+    REQUIRE(picture->data(&w, &h, &stride, &format) == color);
+    REQUIRE(w == 3);
+    REQUIRE(h == 2);
+    REQUIRE(stride == 4);
+    REQUIRE(format == Picture::RGB565);
+    pixels = picture->data();
+    REQUIRE(pixels);
+    for (int i = 0; i < 3*2; ++i) REQUIRE(pixels[i] == 0xff00ff00);
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
@@ -22,6 +22,7 @@
 
 #include <thorvg.h>
 #include "catch.hpp"
+#include "tvgShapeImpl.h"
 
 using namespace tvg;
 
@@ -197,4 +198,64 @@ TEST_CASE("Shape Filling", "[tvgShape]")
     REQUIRE(shape->fillRule() == FillRule::Winding);
     REQUIRE(shape->fill(FillRule::EvenOdd) == Result::Success);
     REQUIRE(shape->fillRule() == FillRule::EvenOdd);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Copy the shared path on write", "[tvgShape]")
+{
+    //The arrays shared by the shape, as the loaders do, and by its duplicates.
+    auto source = ShapePathSource::gen(sizeof(Point) * 2 + sizeof(PathCommand) * 2);
+    REQUIRE(source);
+    auto pts = static_cast<Point*>(source->data());
+    auto cmds = reinterpret_cast<PathCommand*>(pts + 2);
+    pts[0] = {0.0f, 0.0f};
+    pts[1] = {10.0f, 20.0f};
+    cmds[0] = PathCommand::MoveTo;
+    cmds[1] = PathCommand::LineTo;
+
+    auto shape = Shape::gen();
+    REQUIRE(shape);
+    P(shape.get())->sharePath(source, cmds, 2, pts, 2);
+    source->unref();
+
+    for (int i = 0; i < 2; ++i) {
+        auto dup = unique_ptr<Shape>(static_cast<Shape*>(shape->duplicate()));
+        REQUIRE(dup);
+
+        //The duplicate shares the arrays, not a copy of them.
+        const Point* dupPts;
+        REQUIRE(dup->pathCoords(&dupPts) == 2);
+        REQUIRE(dupPts == pts);
+        const PathCommand* dupCmds;
+        REQUIRE(dup->pathCommands(&dupCmds) == 2);
+        REQUIRE(dupCmds == cmds);
+
+        //The duplicate takes its own arrays, or none, leaving the shared ones to the original.
+        if (i == 0) {
+            REQUIRE(dup->lineTo(30, 40) == Result::Success);
+            REQUIRE(dup->pathCoords(&dupPts) == 3);
+            REQUIRE(dupPts != pts);
+            REQUIRE(dupPts[1].x == 10.0f);
+            REQUIRE(dupPts[1].y == 20.0f);
+            REQUIRE(dupPts[2].x == 30.0f);
+            REQUIRE(dupPts[2].y == 40.0f);
+        } else {
+            REQUIRE(dup->reset() == Result::Success);
+            REQUIRE(dup->pathCoords(&dupPts) == 0);
+            REQUIRE(dup->moveTo(50, 60) == Result::Success);
+        }
+
+        const Point* orgPts;
+        REQUIRE(shape->pathCoords(&orgPts) == 2);
+        REQUIRE(orgPts == pts);
+        REQUIRE(orgPts[0].x == 0.0f);
+        REQUIRE(orgPts[0].y == 0.0f);
+        REQUIRE(orgPts[1].x == 10.0f);
+        REQUIRE(orgPts[1].y == 20.0f);
+
+        const PathCommand* orgCmds;
+        REQUIRE(shape->pathCommands(&orgCmds) == 2);
+        REQUIRE(orgCmds == cmds);
+        REQUIRE(orgCmds[0] == PathCommand::MoveTo);
+        REQUIRE(orgCmds[1] == PathCommand::LineTo);
+    }
+}
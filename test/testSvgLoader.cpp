@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2021 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thorvg.h>
+#include <memory>
+#include <stdlib.h>
+#include <math.h>
+#include "catch.hpp"
+#include "tvgSvgUtil.h"
+
+using namespace tvg;
+using namespace std;
+
+//Hidden, run them with: tvgUnitTests "[benchmark]"
+TEST_CASE("Svg loading benchmark", "[tvgSvgLoader][.benchmark]")
+{
+    REQUIRE(Initializer::init(CanvasEngine::Sw, 0) == Result::Success);
+
+    //The duplicate brings the parsed scene in.
+    BENCHMARK("tiger.svg") {
+        auto picture = Picture::gen();
+        picture->load(TEST_DIR"/tiger.svg");
+        return unique_ptr<Paint>(picture->duplicate());
+    };
+
+    BENCHMARK("gallardo.svg") {
+        auto picture = Picture::gen();
+        picture->load(EXAMPLE_DIR"/gallardo.svg");
+        return unique_ptr<Paint>(picture->duplicate());
+    };
+
+    REQUIRE(Initializer::term(CanvasEngine::Sw) == Result::Success);
+}
+
+TEST_CASE("Svg number parsing", "[tvgSvgLoader]")
+{
+    char* end;
+
+    //Same as the correctly rounded strtof()
+    const char* numbers[] = {
+        "0", "-0", "1", "+12.5", "-0.75", ".5", "5.", "3.14159", "1e10", "1.5e-3", "2E+5", "-7.25e2",
+        "16777217", "0.1", "0.3", "123456.789", "1e-10", "1e22", "9.999999e-23", "1e38", "3.4028235e38",
+        "1.17549435e-38", "1e-45", "3.14159265358979323846264338327950288419716939937510",
+        "123456789012345678901234567890", "0.000000000000000000000000000000123456789012345678901234567890",
+        "00000000000000000000000000001.5", "1.000000000000000000000000000001", "4.9406564584124654e-324"
+    };
+    for (auto number : numbers) {
+        auto expected = strtof(number, nullptr);
+        auto value = svgUtilStrtof(number, &end);
+        CAPTURE(number);
+        REQUIRE(!memcmp(&value, &expected, sizeof(float)));
+        REQUIRE(*end == '\0');
+    }
+
+    //Out of the float range
+    REQUIRE(svgUtilStrtof("1e39", nullptr) == INFINITY);
+    REQUIRE(svgUtilStrtof("-1e100000", nullptr) == -INFINITY);
+    REQUIRE(svgUtilStrtof("1e-100000", nullptr) == 0.0f);
+    REQUIRE(svgUtilStrtof("0e100000", nullptr) == 0.0f);
+
+    //The end is right after the number
+    const char* text = "  -12.5e2px";
+    REQUIRE(svgUtilStrtof(text, &end) == -1250.0f);
+    REQUIRE(end == text + 9);
+
+    text = "1.5.5";
+    REQUIRE(svgUtilStrtof(text, &end) == 1.5f);
+    REQUIRE(end == text + 3);
+
+    text = "7e";
+    REQUIRE(svgUtilStrtof(text, &end) == 7.0f);
+    REQUIRE(end == text + 1);
+
+    text = "7e+x";
+    REQUIRE(svgUtilStrtof(text, &end) == 7.0f);
+    REQUIRE(end == text + 1);
+
+    text = "2.5em";
+    REQUIRE(svgUtilStrtof(text, &end) == 2.5f);
+    REQUIRE(end == text + 5);
+
+    text = "1,2";
+    REQUIRE(svgUtilStrtof(text, &end) == 1.0f);
+    REQUIRE(end == text + 1);
+
+    //Hexadecimal is not read past the leading zero
+    text = "0x1A";
+    REQUIRE(svgUtilStrtof(text, &end) == 0.0f);
+    REQUIRE(end == text + 1);
+
+    //Not a number, nothing is read
+    const char* invalids[] = {"", " ", ".", "-", "+.", "e5", "inf", "-INFINITY", "nan", "NAN", "x1"};
+    for (auto invalid : invalids) {
+        CAPTURE(invalid);
+        REQUIRE(svgUtilStrtof(invalid, &end) == 0.0f);
+        REQUIRE(end == invalid);
+    }
+}